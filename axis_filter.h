@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+enum class AxisFilterMode : uint8_t
+{
+    OFF,
+    // 自适应低通: 静止时截止频率低 (去抖动), 移动越快截止频率越高 (不拖尾)
+    ONE_EURO,
+    // 匀速模型的卡尔曼滤波, 速度估计更稳定, 适合配合预测使用
+    KALMAN
+};
+
+// 单个摇杆轴的滤波参数, 轴值为 [-1, 1]
+struct AxisFilterConfig
+{
+    AxisFilterMode mode = AxisFilterMode::ONE_EURO;
+    // One-Euro: 静止时的截止频率 (Hz), beta 为截止频率随速度增加的比例
+    float min_cutoff = 1.0f;
+    float beta = 2.0f;
+    float derivative_cutoff = 1.0f;
+    // Kalman: 过程噪声 (加速度方差) 和测量噪声方差
+    float process_noise = 50.0f;
+    float measurement_noise = 1e-4f;
+    // 预测的最大提前量, 0 表示该轴不做预测
+    float max_prediction_ms = 50.0f;
+};
+
+// 单轴滤波状态, 每个样本 O(1), 同时维护速度估计供预测使用
+// 时间用 SDL 事件时间戳 (毫秒), 与读取方的 SDL_GetTicks() 同一时钟
+class AxisFilter
+{
+public:
+    void reset()
+    {
+        initialized_ = false;
+    }
+
+    bool active() const
+    {
+        return initialized_;
+    }
+
+    float update(float value, uint32_t timestamp_ms, const AxisFilterConfig &config)
+    {
+        if (!initialized_ || config.mode == AxisFilterMode::OFF)
+        {
+            x_ = value;
+            v_ = 0.0f;
+            p00_ = config.measurement_noise;
+            p01_ = 0.0f;
+            p11_ = 1.0f;
+            t_ = timestamp_ms;
+            initialized_ = true;
+            return value;
+        }
+
+        // 同一毫秒内的多个事件按 1ms 处理, 长时间静止后的第一个事件最多按 1s 处理
+        float dt = static_cast<float>(static_cast<int32_t>(timestamp_ms - t_)) * 0.001f;
+        if (dt < 0.001f)
+            dt = 0.001f;
+        if (dt > 1.0f)
+            dt = 1.0f;
+        t_ = timestamp_ms;
+
+        if (config.mode == AxisFilterMode::ONE_EURO)
+        {
+            float dx = (value - x_) / dt;
+            v_ += alpha(dt, config.derivative_cutoff) * (dx - v_);
+            float cutoff = config.min_cutoff + config.beta * std::fabs(v_);
+            x_ += alpha(dt, cutoff) * (value - x_);
+            return x_;
+        }
+
+        // 预测
+        float q = config.process_noise;
+        float dt2 = dt * dt;
+        x_ += v_ * dt;
+        p00_ += dt * (2.0f * p01_ + dt * p11_) + q * dt2 * dt2 * 0.25f;
+        p01_ += dt * p11_ + q * dt2 * dt * 0.5f;
+        p11_ += q * dt2;
+        // 更新
+        float s = p00_ + config.measurement_noise;
+        float k0 = p00_ / s;
+        float k1 = p01_ / s;
+        float y = value - x_;
+        x_ += k0 * y;
+        v_ += k1 * y;
+        p11_ -= k1 * p01_;
+        p01_ -= k0 * p01_;
+        p00_ -= k0 * p00_;
+        return x_;
+    }
+
+    // 按当前速度外推到 at_ms, 提前量不超过 max_prediction_ms
+    float predict(uint32_t at_ms, const AxisFilterConfig &config) const
+    {
+        float ahead = static_cast<float>(static_cast<int32_t>(at_ms - t_));
+        if (ahead < 0.0f)
+            ahead = 0.0f;
+        if (ahead > config.max_prediction_ms)
+            ahead = config.max_prediction_ms;
+        float value = x_ + v_ * ahead * 0.001f;
+        if (value > 1.0f)
+            value = 1.0f;
+        if (value < -1.0f)
+            value = -1.0f;
+        return value;
+    }
+
+private:
+    static float alpha(float dt, float cutoff)
+    {
+        float tau = 1.0f / (2.0f * 3.14159265f * cutoff);
+        return 1.0f / (1.0f + tau / dt);
+    }
+
+    float x_ = 0.0f;
+    float v_ = 0.0f;
+    float p00_ = 0.0f, p01_ = 0.0f, p11_ = 0.0f;
+    uint32_t t_ = 0;
+    bool initialized_ = false;
+};
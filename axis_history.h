@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// 一个轴在一个时间窗口内的统计
+struct AxisWindowStats
+{
+    float min = 0.0f;
+    float max = 0.0f;
+    float avg = 0.0f;      // 窗口内样本的平均值
+    float velocity = 0.0f; // 窗口内最早和最新样本的差分, 单位/秒
+    uint32_t samples = 0;
+};
+
+// 按轴保存最近的样本, 维护若干固定时间窗口内的最小/最大/平均值和速度。
+// 写者 (事件线程) 每个轴事件 record 一次, 不会漏掉一批事件中间的峰值; 每轮 publish 一次,
+// 窗口按当前时间滑动 (没有新事件时保留最新样本, 即轴当前保持的值), 算好的统计按 seqlock 发布。
+// 最小/最大值用单调队列, 平均值用滑动和, 写者每个样本均摊 O(1); 任意线程读取不加锁
+class AxisHistory
+{
+public:
+    static constexpr std::size_t MAX_AXES = 16;
+    static constexpr std::size_t MAX_WINDOWS = 4;
+
+    // windows_ms 超过 MAX_WINDOWS 的部分忽略; capacity 为每个轴保留的样本数 (取 2 的幂),
+    // 窗口内样本超过容量时窗口按样本数截短
+    explicit AxisHistory(const std::vector<uint32_t> &windows_ms, std::size_t capacity = 512)
+        : capacity_(roundUp(capacity))
+    {
+        for (std::size_t i = 0; i < windows_ms.size() && i < MAX_WINDOWS; ++i)
+            windows_ms_.push_back(windows_ms[i]);
+        std::memset(published_, 0, sizeof(published_));
+    }
+
+    std::size_t windowCount() const
+    {
+        return windows_ms_.size();
+    }
+
+    uint32_t windowMs(std::size_t window) const
+    {
+        return window < windows_ms_.size() ? windows_ms_[window] : 0;
+    }
+
+    // 写者: 清空历史并设置轴数 (设备接入或切换时), 下一次 publish 生效
+    void reset(std::size_t count)
+    {
+        if (count > MAX_AXES)
+            count = MAX_AXES;
+        axes_.resize(count);
+        for (Axis &axis : axes_)
+        {
+            axis.values.assign(capacity_, 0.0f);
+            axis.timestamps.assign(capacity_, 0);
+            axis.next = 0;
+            for (Window &window : axis.windows)
+            {
+                window.start = 0;
+                window.sum = 0.0;
+                window.min.slots.assign(capacity_, 0);
+                window.min.head = window.min.tail = 0;
+                window.max.slots.assign(capacity_, 0);
+                window.max.head = window.max.tail = 0;
+            }
+        }
+    }
+
+    // 写者: 追加一个轴的新值; 时间戳不早于该轴之前的样本
+    void record(std::size_t axis_index, uint32_t timestamp_ms, float value)
+    {
+        if (axis_index >= axes_.size())
+            return;
+        Axis &axis = axes_[axis_index];
+        uint64_t n = axis.next;
+        // 先移出旧样本再写入: 新样本会覆盖最早的槽位, 被覆盖的样本必须已经不在任何窗口和队列里
+        for (std::size_t w = 0; w < windows_ms_.size(); ++w)
+        {
+            Window &window = axis.windows[w];
+            evict(axis, window, windows_ms_[w], n, timestamp_ms);
+            // 窗口清空时滑动和归零, 浮点误差不会一直累积
+            if (window.start == n)
+                window.sum = 0.0;
+        }
+        axis.values[n & (capacity_ - 1)] = value;
+        axis.timestamps[n & (capacity_ - 1)] = timestamp_ms;
+        axis.next = n + 1;
+        for (std::size_t w = 0; w < windows_ms_.size(); ++w)
+        {
+            Window &window = axis.windows[w];
+            window.sum += value;
+            enqueue(axis, window.min, n, [](float queued, float v)
+                    { return queued >= v; });
+            enqueue(axis, window.max, n, [](float queued, float v)
+                    { return queued <= v; });
+        }
+    }
+
+    // 写者: 把窗口滑动到 now_ms 并发布所有轴的统计
+    void publish(uint32_t now_ms)
+    {
+        uint32_t seq = __atomic_load_n(&seq_, __ATOMIC_RELAXED);
+        __atomic_store_n(&seq_, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (std::size_t a = 0; a < axes_.size(); ++a)
+        {
+            Axis &axis = axes_[a];
+            for (std::size_t w = 0; w < windows_ms_.size(); ++w)
+            {
+                AxisWindowStats stats;
+                if (axis.next > 0)
+                {
+                    Window &window = axis.windows[w];
+                    uint64_t newest = axis.next - 1;
+                    // 保留最新样本: 轴没有新事件时保持这个值
+                    evict(axis, window, windows_ms_[w], newest, now_ms);
+                    stats.samples = static_cast<uint32_t>(axis.next - window.start);
+                    stats.min = value(axis, window.min.slots[window.min.head & (capacity_ - 1)]);
+                    stats.max = value(axis, window.max.slots[window.max.head & (capacity_ - 1)]);
+                    stats.avg = static_cast<float>(window.sum / stats.samples);
+                    int32_t dt_ms = static_cast<int32_t>(timestamp(axis, newest) - timestamp(axis, window.start));
+                    stats.velocity =
+                        dt_ms > 0 ? (value(axis, newest) - value(axis, window.start)) * 1000.0f / dt_ms : 0.0f;
+                }
+                std::memcpy(&published_[a][w], &stats, sizeof(stats));
+            }
+        }
+        __atomic_store_n(&published_axes_, static_cast<uint32_t>(axes_.size()), __ATOMIC_RELAXED);
+        __atomic_store_n(&seq_, seq + 2, __ATOMIC_RELEASE);
+    }
+
+    // 任意线程: 读取第 axis 个轴在第 window 个窗口的统计; 没有该轴/窗口或写者长时间占用时返回 false
+    bool query(std::size_t axis, std::size_t window, AxisWindowStats &out) const
+    {
+        if (axis >= MAX_AXES || window >= MAX_WINDOWS)
+            return false;
+        constexpr int MAX_RETRIES = 1024;
+        for (int i = 0; i < MAX_RETRIES; ++i)
+        {
+            uint32_t before = __atomic_load_n(&seq_, __ATOMIC_ACQUIRE);
+            if (before & 1u)
+                continue;
+            std::memcpy(&out, &published_[axis][window], sizeof(out));
+            uint32_t axes = __atomic_load_n(&published_axes_, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&seq_, __ATOMIC_RELAXED) == before)
+                return axis < axes && window < windows_ms_.size();
+        }
+        return false;
+    }
+
+private:
+    // 单调队列, 存样本序号, 容量与样本环相同
+    struct Deque
+    {
+        std::vector<uint64_t> slots;
+        uint64_t head = 0;
+        uint64_t tail = 0;
+    };
+
+    struct Window
+    {
+        uint64_t start = 0; // 窗口内最早样本的序号
+        double sum = 0.0;
+        Deque min;
+        Deque max;
+    };
+
+    struct Axis
+    {
+        std::vector<float> values;
+        std::vector<uint32_t> timestamps;
+        uint64_t next = 0; // 下一个样本的序号
+        Window windows[MAX_WINDOWS];
+    };
+
+    static std::size_t roundUp(std::size_t n)
+    {
+        std::size_t p = 2;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    float value(const Axis &axis, uint64_t index) const
+    {
+        return axis.values[index & (capacity_ - 1)];
+    }
+
+    uint32_t timestamp(const Axis &axis, uint64_t index) const
+    {
+        return axis.timestamps[index & (capacity_ - 1)];
+    }
+
+    // 新样本 n 入队: 队尾不优于它的样本以后不会再成为最值
+    template <typename Worse>
+    void enqueue(const Axis &axis, Deque &q, uint64_t n, Worse worse) const
+    {
+        float v = value(axis, n);
+        while (q.tail != q.head && worse(value(axis, q.slots[(q.tail - 1) & (capacity_ - 1)]), v))
+            --q.tail;
+        q.slots[q.tail++ & (capacity_ - 1)] = n;
+    }
+
+    static void dequeue(Deque &q, uint64_t index, std::size_t capacity)
+    {
+        if (q.head != q.tail && q.slots[q.head & (capacity - 1)] == index)
+            ++q.head;
+    }
+
+    // 移出序号 keep 之前超出时间窗口或占满容量的样本; keep 为新样本时窗口里最多留 capacity_ - 1 个旧样本
+    void evict(Axis &axis, Window &window, uint32_t window_ms, uint64_t keep, uint32_t now_ms)
+    {
+        while (window.start < keep &&
+               (static_cast<int32_t>(now_ms - timestamp(axis, window.start)) > static_cast<int32_t>(window_ms) ||
+                keep - window.start >= capacity_))
+        {
+            window.sum -= value(axis, window.start);
+            dequeue(window.min, window.start, capacity_);
+            dequeue(window.max, window.start, capacity_);
+            ++window.start;
+        }
+    }
+
+    // 以下只在写者线程访问
+    const std::size_t capacity_;
+    std::vector<uint32_t> windows_ms_; // 构造后不变, 读者也会读取
+    std::vector<Axis> axes_;
+
+    // 按 seq_ 发布给读者
+    uint32_t seq_ = 0;
+    uint32_t published_axes_ = 0;
+    AxisWindowStats published_[MAX_AXES][MAX_WINDOWS];
+};
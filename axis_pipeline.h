@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "axis_filter.h"
+
+// 摇杆轴处理流水线: 每个阶段是 float operator()(float value, const AxisContext &ctx) const,
+// 输入为原始轴值 (-32768..32767), 一般第一个阶段是 CalibrateStage
+
+// 当前样本的上下文; 滤波状态按轴保存在调用方, 阶段本身不带状态, 同一条流水线可用于所有轴
+struct AxisContext
+{
+    float rest = 0.0f; // 校准的静止位置 (原始值)
+    uint32_t timestamp_ms = 0;
+    AxisFilter *filter = nullptr;
+    const AxisFilterConfig *filter_config = nullptr;
+};
+
+// 减去静止位置, 标准化到 [-1, 1]
+struct CalibrateStage
+{
+    float operator()(float value, const AxisContext &ctx) const
+    {
+        value = (value - ctx.rest) / 32767.0f;
+        if (value > 1.0f)
+            value = 1.0f;
+        if (value < -1.0f)
+            value = -1.0f;
+        return value;
+    }
+};
+
+// 单轴死区
+struct DeadzoneStage
+{
+    float threshold;
+
+    explicit DeadzoneStage(float threshold = 0.1f)
+        : threshold(threshold)
+    {
+    }
+
+    float operator()(float value, const AxisContext &) const
+    {
+        return std::fabs(value) < threshold ? 0.0f : value;
+    }
+};
+
+// 响应曲线: 保留符号的幂函数, exponent > 1 时中心区域更细
+struct CurveStage
+{
+    float exponent;
+
+    explicit CurveStage(float exponent = 1.0f)
+        : exponent(exponent)
+    {
+    }
+
+    float operator()(float value, const AxisContext &) const
+    {
+        if (exponent == 1.0f)
+            return value;
+        float magnitude = std::pow(std::fabs(value), exponent);
+        return value < 0.0f ? -magnitude : magnitude;
+    }
+};
+
+// 滤波 (见 AxisFilter), 上下文里没有滤波状态时直接通过
+struct FilterStage
+{
+    float operator()(float value, const AxisContext &ctx) const
+    {
+        if (!ctx.filter || !ctx.filter_config)
+            return value;
+        return ctx.filter->update(value, ctx.timestamp_ms, *ctx.filter_config);
+    }
+};
+
+// 线性映射 value * scale + offset, 结果限制在 [-1, 1]
+struct MapStage
+{
+    float scale;
+    float offset;
+
+    explicit MapStage(float scale = 1.0f, float offset = 0.0f)
+        : scale(scale), offset(offset)
+    {
+    }
+
+    float operator()(float value, const AxisContext &) const
+    {
+        value = value * scale + offset;
+        if (value > 1.0f)
+            value = 1.0f;
+        if (value < -1.0f)
+            value = -1.0f;
+        return value;
+    }
+};
+
+// 编译期组合: 阶段按模板参数顺序展开成直线代码, 没有虚调用
+template <typename... Stages>
+class AxisPipeline
+{
+public:
+    AxisPipeline() = default;
+
+    explicit AxisPipeline(const Stages &...stages)
+        : stages_(stages...)
+    {
+    }
+
+    float operator()(float value, const AxisContext &ctx) const
+    {
+        return run<0>(value, ctx);
+    }
+
+    template <std::size_t I>
+    typename std::tuple_element<I, std::tuple<Stages...>>::type &stage()
+    {
+        return std::get<I>(stages_);
+    }
+
+private:
+    template <std::size_t I>
+    typename std::enable_if<I == sizeof...(Stages), float>::type run(float value, const AxisContext &) const
+    {
+        return value;
+    }
+
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Stages)), float>::type run(float value, const AxisContext &ctx) const
+    {
+        return run<I + 1>(std::get<I>(stages_)(value, ctx), ctx);
+    }
+
+    std::tuple<Stages...> stages_;
+};
+
+// 运行期组合用的阶段接口
+class AxisStage
+{
+public:
+    virtual ~AxisStage() {}
+    virtual float process(float value, const AxisContext &ctx) const = 0;
+};
+
+template <typename Stage>
+class AxisStageAdapter : public AxisStage
+{
+public:
+    explicit AxisStageAdapter(const Stage &stage)
+        : stage_(stage)
+    {
+    }
+
+    float process(float value, const AxisContext &ctx) const override
+    {
+        return stage_(value, ctx);
+    }
+
+private:
+    Stage stage_;
+};
+
+// 运行期组合: 阶段顺序和参数可以来自配置, 每个阶段一次虚调用
+class DynamicAxisPipeline
+{
+public:
+    template <typename Stage>
+    DynamicAxisPipeline &add(const Stage &stage)
+    {
+        stages_.emplace_back(new AxisStageAdapter<Stage>(stage));
+        return *this;
+    }
+
+    float operator()(float value, const AxisContext &ctx) const
+    {
+        for (const auto &stage : stages_)
+            value = stage->process(value, ctx);
+        return value;
+    }
+
+    std::size_t size() const
+    {
+        return stages_.size();
+    }
+
+    // 按逗号分隔的阶段列表构造, 如 "calibrate,filter,deadzone:0.15,curve:2,map:1.5:0";
+    // 参数用冒号分隔, 省略时取默认值。输入是原始轴值, 第一个阶段必须是 calibrate; 曲线指数必须大于 0
+    static DynamicAxisPipeline parse(const std::string &spec)
+    {
+        DynamicAxisPipeline pipeline;
+        std::size_t begin = 0;
+        while (begin <= spec.size())
+        {
+            std::size_t end = spec.find(',', begin);
+            if (end == std::string::npos)
+                end = spec.size();
+            std::string item = spec.substr(begin, end - begin);
+            begin = end + 1;
+            if (item.empty())
+                continue;
+
+            std::vector<float> params;
+            std::size_t colon = item.find(':');
+            std::string name = item.substr(0, colon);
+            while (colon != std::string::npos)
+            {
+                std::size_t next = item.find(':', colon + 1);
+                std::string text = item.substr(colon + 1, next == std::string::npos ? std::string::npos : next - colon - 1);
+                char *parsed_end = nullptr;
+                float param = std::strtof(text.c_str(), &parsed_end);
+                if (text.empty() || *parsed_end != '\0' || !std::isfinite(param))
+                    throw std::runtime_error("Axis pipeline: bad parameter in '" + item + "'");
+                params.push_back(param);
+                colon = next;
+            }
+
+            if (pipeline.size() == 0 && name != "calibrate")
+                throw std::runtime_error("Axis pipeline: first stage must be 'calibrate', got '" + name + "'");
+
+            if (name == "calibrate")
+                pipeline.add(CalibrateStage());
+            else if (name == "filter")
+                pipeline.add(FilterStage());
+            else if (name == "deadzone")
+                pipeline.add(params.empty() ? DeadzoneStage() : DeadzoneStage(params[0]));
+            else if (name == "curve")
+            {
+                if (!params.empty() && !(params[0] > 0.0f))
+                    throw std::runtime_error("Axis pipeline: curve exponent must be > 0 in '" + item + "'");
+                pipeline.add(params.empty() ? CurveStage() : CurveStage(params[0]));
+            }
+            else if (name == "map")
+                pipeline.add(MapStage(params.size() > 0 ? params[0] : 1.0f, params.size() > 1 ? params[1] : 0.0f));
+            else
+            {
+                throw std::runtime_error("Axis pipeline: unknown stage '" + name + "'");
+            }
+        }
+        if (pipeline.size() == 0)
+            throw std::runtime_error("Axis pipeline: no stages in '" + spec + "'");
+        return pipeline;
+    }
+
+private:
+    std::vector<std::unique_ptr<AxisStage>> stages_;
+};
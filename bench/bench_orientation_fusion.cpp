@@ -0,0 +1,36 @@
+// Madgwick 姿态融合的单核吞吐: 1 kHz 的陀螺仪样本, 每个样本前一个加速度计样本
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include "bench_util.h"
+#include "orientation_fusion.h"
+
+int main(int argc, char **argv)
+{
+    std::size_t samples = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+
+    // 预先生成一段缓慢转动的输入, 计时只包含融合本身
+    const std::size_t TABLE = 1024;
+    float accel[TABLE][3], gyro[TABLE][3];
+    for (std::size_t i = 0; i < TABLE; ++i)
+    {
+        float t = static_cast<float>(i) * (6.2831853f / TABLE);
+        accel[i][0] = 0.3f * std::sin(t);
+        accel[i][1] = 9.81f;
+        accel[i][2] = 0.3f * std::cos(t);
+        gyro[i][0] = 0.5f * std::cos(t);
+        gyro[i][1] = 0.2f;
+        gyro[i][2] = -0.4f * std::sin(t);
+    }
+
+    MadgwickFilter filter(0.1f);
+    filter.reset();
+    double ns = bench::nsPerOp(samples, [&](std::size_t i)
+                               {
+                                   filter.onAccel(accel[i & (TABLE - 1)]);
+                                   filter.onGyro(gyro[i & (TABLE - 1)], static_cast<uint64_t>(i) * 1000u);
+                               });
+    bench::keep(filter.quaternion());
+    bench::report("madgwick accel+gyro sample", ns);
+    return 0;
+}
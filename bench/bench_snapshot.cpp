@@ -0,0 +1,60 @@
+// getData() 与 getCachedData() 的读取开销: 没有新帧时, 1 到 32 个读者线程同时读取
+// 需要 SDL 能初始化摇杆子系统, 不需要插着手柄
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "bench_util.h"
+#include "joystick_core.h"
+
+namespace
+{
+    // threads 个线程各读 reads 次, 返回每次读取的平均墙钟时间 (所有线程同时开始)
+    template <typename Read>
+    double measure(std::size_t threads, std::size_t reads, Read read)
+    {
+        std::vector<std::thread> workers;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&]
+                                 {
+                                     for (std::size_t i = 0; i < reads; ++i)
+                                         read();
+                                 });
+        }
+        for (std::thread &worker : workers)
+            worker.join();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(reads);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t reads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    try
+    {
+        JoystickOptions options;
+        options.trace = false;
+        SimpleJoystick joystick(options);
+
+        const std::size_t thread_counts[] = {1, 2, 4, 8, 16, 32};
+        for (std::size_t threads : thread_counts)
+        {
+            double copy_ns = measure(threads, reads, [&]
+                                     { bench::keep(joystick.getData().frame_id); });
+            double cached_ns = measure(threads, reads * 10, [&]
+                                       { bench::keep(joystick.getCachedData().frame_id); });
+            std::printf("%2zu reader thread(s)\n", threads);
+            bench::report("  getData()", copy_ns);
+            bench::report("  getCachedData()", cached_ns);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "bench_snapshot: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// 基准测试的小工具: 计时和防止结果被优化掉
+namespace bench
+{
+    // 执行 fn(i) iterations 次, 返回每次的平均纳秒数
+    template <typename Fn>
+    double nsPerOp(std::size_t iterations, Fn fn)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            fn(i);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    template <typename T>
+    void keep(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    inline void report(const char *name, double ns_per_op)
+    {
+        std::printf("%-40s %10.1f ns/op %12.0f op/s\n", name, ns_per_op, 1e9 / ns_per_op);
+    }
+}
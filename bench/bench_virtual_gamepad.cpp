@@ -0,0 +1,79 @@
+// 虚拟手柄输出的输入风暴: 每帧 4 个摇杆轴和 1 个按钮变化, 比较编码本身和加上每帧一次写出的开销
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "bench_util.h"
+#include "virtual_gamepad.h"
+
+namespace
+{
+    // VirtualGamepad::stage() 需要的快照字段
+    struct Frame
+    {
+        bool standard_layout = true;
+        std::vector<float> axes = std::vector<float>(6, 0.0f);
+        std::array<float, 4> triggers = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        uint8_t num_triggers = 2;
+        std::array<uint8_t, 4> hats = {{0, 0, 0, 0}};
+        uint8_t num_hats = 1;
+        std::vector<bool> buttons = std::vector<bool>(21, false);
+    };
+
+    class CountingSink : public VirtualOutputSink
+    {
+    public:
+        bool write(const VirtualEvent *events, std::size_t count) override
+        {
+            bench::keep(events);
+            this->events += count;
+            return true;
+        }
+
+        std::size_t events = 0;
+    };
+
+    // 生成第 i 帧: 摇杆轴每帧都变, 一个按钮交替按下/松开
+    void makeFrame(Frame &frame, std::size_t i)
+    {
+        for (std::size_t a = 0; a < 4; ++a)
+            frame.axes[a] = static_cast<float>(static_cast<int>((i * 37 + a * 101) % 2001) - 1000) / 1000.0f;
+        frame.buttons[i % 15] = !frame.buttons[i % 15];
+    }
+
+    template <typename Sink>
+    double run(std::size_t frames, Sink &sink, std::size_t &events)
+    {
+        VirtualGamepad pad;
+        Frame frame;
+        std::size_t staged = 0;
+        double ns = bench::nsPerOp(frames, [&](std::size_t i)
+                                   {
+                                       makeFrame(frame, i);
+                                       staged += pad.stage(frame) + 1;
+                                       pad.flush(sink);
+                                   });
+        events = staged;
+        return ns;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::size_t events = 0;
+
+    CountingSink counting;
+    double ns = run(frames, counting, events);
+    bench::report("stage+flush, in-memory sink (frame)", ns);
+    std::printf("%-40s %10.1f events/frame\n", "", static_cast<double>(events) / frames);
+
+    // 文件输出与 uinput 一样每帧一次 write(), 写到 /dev/null 只剩系统调用的开销
+    FileOutputSink file("/dev/null");
+    if (file.ok())
+    {
+        ns = run(frames / 4, file, events);
+        bench::report("stage+flush, FileOutputSink (frame)", ns);
+    }
+    return 0;
+}
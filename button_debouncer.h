@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class DebounceMode : uint8_t
+{
+    OFF,
+    // 第一个边沿立即生效, 之后 window 内的抖动忽略; 不增加延迟
+    LEADING_EDGE,
+    // 新状态需要保持 window 才生效, 能滤掉毛刺, 代价是 window 的延迟
+    INTEGRATING
+};
+
+// 按 SDL 事件时间戳 (毫秒) 去抖, 与事件线程的轮询间隔无关
+// 前 64 个按钮的状态放在位图里, 每次边沿和到期处理都是整组的位运算,
+// 只有正在计时的按钮需要逐个比较截止时间
+// 状态只在事件线程访问; 模式和窗口可在任意线程修改
+class ButtonDebouncer
+{
+public:
+    static constexpr std::size_t MAX_BUTTONS = 64;
+
+    ButtonDebouncer()
+    {
+        for (auto &w : window_ms_)
+            w.store(20, std::memory_order_relaxed);
+    }
+
+    void setMode(DebounceMode mode)
+    {
+        mode_.store(mode, std::memory_order_relaxed);
+    }
+
+    DebounceMode mode() const
+    {
+        return mode_.load(std::memory_order_relaxed);
+    }
+
+    void setWindow(uint32_t window_ms)
+    {
+        for (auto &w : window_ms_)
+            w.store(window_ms, std::memory_order_relaxed);
+    }
+
+    void setWindow(std::size_t button, uint32_t window_ms)
+    {
+        if (button < MAX_BUTTONS)
+            window_ms_[button].store(window_ms, std::memory_order_relaxed);
+    }
+
+    // 设备切换时直接采用设备当前状态
+    void reset(uint64_t state)
+    {
+        raw_ = state;
+        stable_ = state;
+        timing_ = 0;
+    }
+
+    // 处理一个原始边沿, 返回 true 表示该边沿被当作抖动丢弃
+    bool onEdge(std::size_t button, bool pressed, uint32_t timestamp_ms)
+    {
+        // 先结算这个时间点之前到期的按钮, 保证按事件时间顺序处理
+        expire(timestamp_ms);
+
+        uint64_t bit = uint64_t(1) << button;
+        uint64_t set_mask = uint64_t(0) - static_cast<uint64_t>(pressed);
+        raw_ = (raw_ & ~bit) | (set_mask & bit);
+        uint64_t diff = (raw_ ^ stable_) & bit;
+
+        switch (mode())
+        {
+        case DebounceMode::OFF:
+            stable_ ^= diff;
+            timing_ &= ~bit;
+            return false;
+
+        case DebounceMode::LEADING_EDGE:
+        {
+            uint64_t accept = diff & ~timing_;
+            stable_ ^= accept;
+            if (accept)
+                arm(button, timestamp_ms);
+            return diff && !accept;
+        }
+
+        case DebounceMode::INTEGRATING:
+        default:
+            // 每个新边沿重新开始计时, 回到稳定状态则取消
+            if (diff)
+            {
+                arm(button, timestamp_ms);
+                return false;
+            }
+            bool cancelled = (timing_ & bit) != 0;
+            timing_ &= ~bit;
+            return cancelled;
+        }
+    }
+
+    // 推进到 now_ms, 返回去抖后的按钮位图
+    uint64_t update(uint32_t now_ms)
+    {
+        expire(now_ms);
+        return stable_;
+    }
+
+    uint64_t stable() const
+    {
+        return stable_;
+    }
+
+    bool hasPending() const
+    {
+        return timing_ != 0;
+    }
+
+    // 最近一个到期时间, 事件线程据此缩短等待
+    uint32_t nextDeadline() const
+    {
+        uint32_t next = 0;
+        bool found = false;
+        for (uint64_t bits = timing_; bits; bits &= bits - 1)
+        {
+            uint32_t d = deadline_[__builtin_ctzll(bits)];
+            if (!found || static_cast<int32_t>(d - next) < 0)
+                next = d;
+            found = true;
+        }
+        return next;
+    }
+
+private:
+    void arm(std::size_t button, uint32_t timestamp_ms)
+    {
+        timing_ |= uint64_t(1) << button;
+        deadline_[button] = timestamp_ms + window_ms_[button].load(std::memory_order_relaxed);
+    }
+
+    void expire(uint32_t now_ms)
+    {
+        if (!timing_)
+            return;
+
+        uint64_t expired = 0;
+        for (uint64_t bits = timing_; bits; bits &= bits - 1)
+        {
+            unsigned b = __builtin_ctzll(bits);
+            // 时间戳回绕安全的比较
+            uint64_t due = static_cast<uint64_t>(static_cast<int32_t>(now_ms - deadline_[b]) >= 0);
+            expired |= due << b;
+        }
+        timing_ &= ~expired;
+
+        // 到期时原始状态与稳定状态不同的按钮: 积分模式下是新状态生效,
+        // 前沿模式下是锁定期间发生了释放/按下, 补上这次变化并重新锁定
+        uint64_t flip = expired & (raw_ ^ stable_);
+        stable_ ^= flip;
+        if (mode() == DebounceMode::LEADING_EDGE)
+        {
+            for (uint64_t bits = flip; bits; bits &= bits - 1)
+                arm(__builtin_ctzll(bits), now_ms);
+        }
+    }
+
+    std::atomic<DebounceMode> mode_{DebounceMode::LEADING_EDGE};
+    std::atomic<uint32_t> window_ms_[MAX_BUTTONS];
+
+    uint64_t raw_ = 0;
+    uint64_t stable_ = 0;
+    uint64_t timing_ = 0;
+    uint32_t deadline_[MAX_BUTTONS] = {};
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "joystick_metrics.h"
+#include "joystick_trace.h"
+
+// 单个命令的派发策略
+struct CommandPolicy
+{
+    // 两次触发的最小间隔, 间隔内的重复触发直接丢弃
+    std::chrono::milliseconds debounce{0};
+    // 令牌桶: 每秒补充 rate_per_sec 个令牌, 最多存 burst 个; rate_per_sec 为 0 表示不限速
+    double rate_per_sec = 0.0;
+    double burst = 1.0;
+    // 数值越大越先派发, 同优先级按提交顺序
+    int priority = 0;
+    // 没有令牌时最多积压的次数, 超出的丢弃
+    std::size_t max_pending = 4;
+};
+
+// 令牌桶, 时间由调用者传入
+class TokenBucket
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // 新建的桶是满的; rate_per_sec 为 0 表示不限速
+    TokenBucket(double rate_per_sec = 0.0, double burst = 1.0, Clock::time_point now = Clock::time_point())
+        : rate_per_sec_(rate_per_sec), burst_(burst), tokens_(burst), last_refill_(now)
+    {
+    }
+
+    // 改变速率和容量: 先按旧速率补到 now, 已有令牌保留, 超出新容量的部分丢弃
+    void configure(double rate_per_sec, double burst, Clock::time_point now)
+    {
+        refill(now);
+        rate_per_sec_ = rate_per_sec;
+        burst_ = burst;
+        tokens_ = std::min(tokens_, burst);
+        last_refill_ = now;
+    }
+
+    // 不限速时总是成功
+    bool take(Clock::time_point now)
+    {
+        if (rate_per_sec_ <= 0.0)
+            return true;
+        refill(now);
+        if (tokens_ < 1.0)
+            return false;
+        tokens_ -= 1.0;
+        return true;
+    }
+
+    double tokens(Clock::time_point now)
+    {
+        refill(now);
+        return tokens_;
+    }
+
+    // 下一个令牌到达的时间
+    Clock::time_point nextToken(Clock::time_point now) const
+    {
+        double wait = (1.0 - tokens_) / rate_per_sec_;
+        return now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait));
+    }
+
+private:
+    void refill(Clock::time_point now)
+    {
+        if (rate_per_sec_ > 0.0 && now > last_refill_)
+        {
+            double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+            tokens_ = std::min(burst_, tokens_ + elapsed * rate_per_sec_);
+        }
+        last_refill_ = std::max(last_refill_, now);
+    }
+
+    double rate_per_sec_;
+    double burst_;
+    double tokens_;
+    Clock::time_point last_refill_;
+};
+
+// 按钮触发的命令先进这里, 经过去抖、限速和优先级排序后在独立线程上派发
+// submit() 只持有很短的锁, 不会执行命令本身
+class CommandScheduler
+{
+public:
+    typedef std::function<void(int command_id)> Handler;
+
+    // tracer 不为空时记录每条命令的排队和执行阶段
+    CommandScheduler(Handler handler, MetricsRegistry &registry, FrameTracer *tracer = nullptr)
+        : handler_(handler),
+          tracer_(tracer),
+          dispatched_(registry.counter("joystick_commands_dispatched_total", "Commands handed to the handler")),
+          dropped_debounce_(registry.counter("joystick_commands_dropped_total", "Commands discarded before dispatch", "reason=\"debounce\"")),
+          dropped_overflow_(registry.counter("joystick_commands_dropped_total", "Commands discarded before dispatch", "reason=\"overflow\"")),
+          deferred_(registry.counter("joystick_commands_deferred_total", "Commands that waited for a rate-limit token")),
+          pending_(registry.gauge("joystick_commands_pending", "Commands queued for dispatch")),
+          dispatch_latency_ns_(registry.histogram("joystick_command_dispatch_latency_ns", "Submit to dispatch latency in ns"))
+    {
+        thread_ = std::thread(&CommandScheduler::run, this);
+    }
+
+    ~CommandScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    // 新命令的令牌桶是满的; 已有命令重新设置时保留剩余令牌 (按新容量截断), 重新加载配置不会清空限速
+    void setPolicy(int command_id, const CommandPolicy &policy)
+    {
+        if (!(policy.burst >= 1.0) || !std::isfinite(policy.burst))
+            throw std::runtime_error("Command policy: burst must be a finite number >= 1");
+        if (!std::isfinite(policy.rate_per_sec) || policy.rate_per_sec < 0.0)
+            throw std::runtime_error("Command policy: rate_per_sec must be a finite number >= 0");
+        Clock::time_point now = Clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<int, CommandState>::iterator it = commands_.find(command_id);
+        if (it == commands_.end())
+        {
+            CommandState &state = commands_[command_id];
+            state.policy = policy;
+            state.bucket = TokenBucket(policy.rate_per_sec, policy.burst, now);
+            return;
+        }
+        it->second.policy = policy;
+        it->second.bucket.configure(policy.rate_per_sec, policy.burst, now);
+    }
+
+    // 提交一次触发, 被去抖或积压上限丢弃时返回 false; frame_id 为触发它的输入帧, 用于追踪
+    bool submit(int command_id, uint64_t frame_id = 0)
+    {
+        Clock::time_point now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CommandState &state = stateFor(command_id);
+
+            if (state.has_accepted && now - state.last_accepted < state.policy.debounce)
+            {
+                dropped_debounce_.inc();
+                return false;
+            }
+            if (state.pending >= state.policy.max_pending)
+            {
+                dropped_overflow_.inc();
+                return false;
+            }
+
+            state.has_accepted = true;
+            state.last_accepted = now;
+            ++state.pending;
+
+            Pending item;
+            item.command_id = command_id;
+            item.priority = state.policy.priority;
+            item.seq = next_seq_++;
+            item.submitted = now;
+            item.frame_id = frame_id;
+            item.deferred = false;
+            queue_.push_back(item);
+            pending_.set(static_cast<int64_t>(queue_.size()));
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct CommandState
+    {
+        CommandPolicy policy;
+        TokenBucket bucket;
+        Clock::time_point last_accepted;
+        bool has_accepted = false;
+        std::size_t pending = 0;
+    };
+
+    struct Pending
+    {
+        int command_id;
+        int priority;
+        uint64_t seq;
+        Clock::time_point submitted;
+        uint64_t frame_id;
+        bool deferred;
+    };
+
+    CommandState &stateFor(int command_id)
+    {
+        std::map<int, CommandState>::iterator it = commands_.find(command_id);
+        if (it == commands_.end())
+        {
+            // 未配置策略的命令: 不去抖、不限速
+            return commands_[command_id];
+        }
+        return it->second;
+    }
+
+    static uint64_t toNs(Clock::time_point t)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+    }
+
+    void run()
+    {
+        if (tracer_)
+            tracer_->nameThread("commands");
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_)
+        {
+            if (queue_.empty())
+            {
+                cv_.wait(lock);
+                continue;
+            }
+
+            // 高优先级在前, 同优先级先提交的在前
+            std::sort(queue_.begin(), queue_.end(), [](const Pending &a, const Pending &b)
+                      { return a.priority != b.priority ? a.priority > b.priority : a.seq < b.seq; });
+
+            Clock::time_point now = Clock::now();
+            Clock::time_point wake = Clock::time_point::max();
+            std::size_t ready = queue_.size();
+            for (std::size_t i = 0; i < queue_.size(); ++i)
+            {
+                CommandState &state = commands_[queue_[i].command_id];
+                if (state.bucket.take(now))
+                {
+                    ready = i;
+                    break;
+                }
+                if (!queue_[i].deferred)
+                {
+                    queue_[i].deferred = true;
+                    deferred_.inc();
+                }
+                wake = std::min(wake, state.bucket.nextToken(now));
+            }
+
+            if (ready == queue_.size())
+            {
+                // 所有积压命令都在等令牌
+                cv_.wait_until(lock, wake);
+                continue;
+            }
+
+            Pending item = queue_[ready];
+            queue_.erase(queue_.begin() + ready);
+            --commands_[item.command_id].pending;
+            pending_.set(static_cast<int64_t>(queue_.size()));
+
+            // 执行命令时不持锁, submit() 不会被处理函数阻塞
+            lock.unlock();
+            Clock::time_point start = Clock::now();
+            dispatch_latency_ns_.observe(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - item.submitted).count()));
+            dispatched_.inc();
+            if (tracer_)
+                tracer_->record("command_queued", item.frame_id, toNs(item.submitted), toNs(start), item.command_id);
+            {
+                TraceScope dispatch(tracer_, "command_dispatch", item.frame_id);
+                dispatch.setArg(item.command_id);
+                handler_(item.command_id);
+            }
+            lock.lock();
+        }
+    }
+
+    Handler handler_;
+    FrameTracer *tracer_;
+    MetricCounter &dispatched_;
+    MetricCounter &dropped_debounce_;
+    MetricCounter &dropped_overflow_;
+    MetricCounter &deferred_;
+    MetricGauge &pending_;
+    MetricHistogram &dispatch_latency_ns_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<int, CommandState> commands_;
+    std::vector<Pending> queue_;
+    uint64_t next_seq_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 标准手柄布局的按钮/轴名称, 顺序与 SDL_GameControllerButton / SDL_GameControllerAxis 一致
+namespace mapping_detail
+{
+    const char *const BUTTON_NAMES[] = {
+        "a", "b", "x", "y", "back", "guide", "start", "leftstick", "rightstick",
+        "leftshoulder", "rightshoulder", "dpup", "dpdown", "dpleft", "dpright",
+        "misc1", "paddle1", "paddle2", "paddle3", "paddle4", "touchpad"};
+    const char *const AXIS_NAMES[] = {
+        "leftx", "lefty", "rightx", "righty", "lefttrigger", "righttrigger"};
+
+    template <std::size_t N>
+    int indexOf(const char *const (&names)[N], std::size_t limit, const std::string &name)
+    {
+        for (std::size_t i = 0; i < N && i < limit; ++i)
+        {
+            if (name == names[i])
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // SDL 事件里按钮/轴/方向键的下标都是 Uint8
+    constexpr unsigned long MAX_SOURCE_INDEX = 255;
+
+    // 解析映射源中的下标, 没有数字或超出 SDL 的范围时返回 false
+    inline bool parseIndex(const char *text, char **end, std::size_t &index)
+    {
+        char *parsed_end = nullptr;
+        unsigned long value = std::strtoul(text, &parsed_end, 10);
+        if (parsed_end == text || *text == '-' || value > MAX_SOURCE_INDEX)
+            return false;
+        if (end)
+            *end = parsed_end;
+        index = static_cast<std::size_t>(value);
+        return true;
+    }
+
+    // 64 位 FNV-1a, seed 参与初始值, 用于两级完美哈希
+    inline uint64_t hashGuid(const SDL_JoystickGUID &guid, uint64_t seed)
+    {
+        uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+        for (std::size_t i = 0; i < sizeof(guid.data); ++i)
+        {
+            h ^= guid.data[i];
+            h *= 1099511628211ull;
+        }
+        // 末尾再混合一次, 改善低位分布
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 32;
+        return h;
+    }
+}
+
+constexpr std::size_t STANDARD_BUTTON_COUNT = SDL_CONTROLLER_BUTTON_MAX;
+constexpr std::size_t STANDARD_AXIS_COUNT = SDL_CONTROLLER_AXIS_MAX;
+
+// 一个设备型号的原始索引 -> 标准布局索引映射, 设备接入时解析一次,
+// 之后每个事件只做一次数组下标访问
+struct ControllerMapping
+{
+    struct AxisSource
+    {
+        int8_t target = -1; // 标准轴, -1 表示未映射
+        bool invert = false;
+    };
+
+    std::string name;
+    std::vector<int8_t> button_to_button;            // 原始按钮 -> 标准按钮
+    std::vector<int8_t> button_to_axis;              // 原始按钮 -> 标准轴 (部分手柄的数字扳机)
+    std::vector<AxisSource> axis_to_axis;            // 原始轴 -> 标准轴
+    std::vector<std::array<int8_t, 4>> hat_to_button; // 原始方向键的 上/右/下/左 -> 标准按钮
+};
+
+// 解析一行 SDL 映射字符串: "GUID,名称,a:b0,b:b1,leftx:a0,dpup:h0.1,..."
+// 源下标超出 SDL 范围的整行拒绝, 错误的映射文件不会引起超大的表
+inline bool parseControllerMapping(const std::string &line, SDL_JoystickGUID &guid, ControllerMapping &mapping)
+{
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (start <= line.size())
+    {
+        std::size_t comma = line.find(',', start);
+        if (comma == std::string::npos)
+            comma = line.size();
+        fields.push_back(line.substr(start, comma - start));
+        start = comma + 1;
+    }
+    if (fields.size() < 3 || fields[0].size() != 32)
+        return false;
+
+    guid = SDL_JoystickGetGUIDFromString(fields[0].c_str());
+    mapping = ControllerMapping();
+    mapping.name = fields[1];
+
+    for (std::size_t i = 2; i < fields.size(); ++i)
+    {
+        const std::string &field = fields[i];
+        std::size_t colon = field.find(':');
+        if (colon == std::string::npos || colon + 2 > field.size())
+            continue;
+
+        std::string target = field.substr(0, colon);
+        std::string source = field.substr(colon + 1);
+        // 半轴映射 (+a1/-a1) 按整轴处理
+        if (!target.empty() && (target[0] == '+' || target[0] == '-'))
+            target.erase(0, 1);
+        if (!source.empty() && (source[0] == '+' || source[0] == '-'))
+            source.erase(0, 1);
+        bool invert = !source.empty() && source[source.size() - 1] == '~';
+        if (invert)
+            source.erase(source.size() - 1);
+        if (source.size() < 2)
+            continue;
+
+        int button = mapping_detail::indexOf(mapping_detail::BUTTON_NAMES, STANDARD_BUTTON_COUNT, target);
+        int axis = mapping_detail::indexOf(mapping_detail::AXIS_NAMES, STANDARD_AXIS_COUNT, target);
+        if (button < 0 && axis < 0)
+            continue;
+
+        char kind = source[0];
+        if (kind == 'b')
+        {
+            std::size_t index = 0;
+            if (!mapping_detail::parseIndex(source.c_str() + 1, nullptr, index))
+                return false;
+            if (button >= 0)
+            {
+                if (mapping.button_to_button.size() <= index)
+                    mapping.button_to_button.resize(index + 1, -1);
+                mapping.button_to_button[index] = static_cast<int8_t>(button);
+            }
+            else
+            {
+                if (mapping.button_to_axis.size() <= index)
+                    mapping.button_to_axis.resize(index + 1, -1);
+                mapping.button_to_axis[index] = static_cast<int8_t>(axis);
+            }
+        }
+        else if (kind == 'a' && axis >= 0)
+        {
+            std::size_t index = 0;
+            if (!mapping_detail::parseIndex(source.c_str() + 1, nullptr, index))
+                return false;
+            if (mapping.axis_to_axis.size() <= index)
+                mapping.axis_to_axis.resize(index + 1);
+            mapping.axis_to_axis[index].target = static_cast<int8_t>(axis);
+            mapping.axis_to_axis[index].invert = invert;
+        }
+        else if (kind == 'h' && button >= 0)
+        {
+            char *dot = nullptr;
+            std::size_t hat = 0;
+            if (!mapping_detail::parseIndex(source.c_str() + 1, &dot, hat))
+                return false;
+            if (*dot != '.')
+                continue;
+            unsigned long mask = std::strtoul(dot + 1, nullptr, 10);
+            if (mask == 0 || (mask & (mask - 1)) != 0 || mask > SDL_HAT_LEFT)
+                continue;
+            if (mapping.hat_to_button.size() <= hat)
+            {
+                std::array<int8_t, 4> none;
+                none.fill(-1);
+                mapping.hat_to_button.resize(hat + 1, none);
+            }
+            mapping.hat_to_button[hat][__builtin_ctz(mask)] = static_cast<int8_t>(button);
+        }
+    }
+    return true;
+}
+
+// 自定义映射文件加载后编译成以 GUID 为键的完美哈希表:
+// 第一级哈希选桶, 每个桶存一个位移种子, 第二级哈希直接定位到唯一槽位, 查找只比较一次键
+class MappingTable
+{
+public:
+    bool loadFile(const std::string &path, std::string &error)
+    {
+        std::ifstream in(path.c_str());
+        if (!in)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        std::vector<Entry> entries;
+        std::map<std::string, std::size_t> seen;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line[line.size() - 1] == '\r')
+                line.erase(line.size() - 1);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            Entry entry;
+            ControllerMapping mapping;
+            if (!parseControllerMapping(line, entry.guid, mapping))
+                continue;
+            entry.mapping = std::make_shared<const ControllerMapping>(mapping);
+
+            // 同一 GUID 出现多次时以后出现的为准
+            std::string key(reinterpret_cast<const char *>(entry.guid.data), sizeof(entry.guid.data));
+            std::map<std::string, std::size_t>::iterator it = seen.find(key);
+            if (it != seen.end())
+            {
+                entries[it->second] = entry;
+            }
+            else
+            {
+                seen[key] = entries.size();
+                entries.push_back(entry);
+            }
+        }
+        build(entries);
+        return true;
+    }
+
+    std::shared_ptr<const ControllerMapping> find(const SDL_JoystickGUID &guid) const
+    {
+        if (slots_.empty())
+            return nullptr;
+        std::size_t bucket = mapping_detail::hashGuid(guid, 0) % seeds_.size();
+        std::size_t slot = mapping_detail::hashGuid(guid, seeds_[bucket]) % slots_.size();
+        const Entry &entry = slots_[slot];
+        if (!entry.mapping || std::memcmp(entry.guid.data, guid.data, sizeof(guid.data)) != 0)
+            return nullptr;
+        return entry.mapping;
+    }
+
+    std::size_t size() const
+    {
+        return count_;
+    }
+
+private:
+    struct Entry
+    {
+        SDL_JoystickGUID guid;
+        std::shared_ptr<const ControllerMapping> mapping;
+    };
+
+    void build(const std::vector<Entry> &entries)
+    {
+        count_ = entries.size();
+        slots_.assign(count_, Entry());
+        seeds_.assign(std::max<std::size_t>(1, (count_ + 3) / 4), 0);
+        if (count_ == 0)
+            return;
+
+        std::vector<std::vector<std::size_t>> buckets(seeds_.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            buckets[mapping_detail::hashGuid(entries[i].guid, 0) % seeds_.size()].push_back(i);
+
+        // 先放大的桶, 冲突概率最低
+        std::vector<std::size_t> order(buckets.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&buckets](std::size_t a, std::size_t b)
+                  { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<bool> used(count_, false);
+        std::vector<std::size_t> placed;
+        for (std::size_t b : order)
+        {
+            if (buckets[b].empty())
+                break;
+            for (uint64_t seed = 1;; ++seed)
+            {
+                placed.clear();
+                bool ok = true;
+                for (std::size_t index : buckets[b])
+                {
+                    std::size_t slot = mapping_detail::hashGuid(entries[index].guid, seed) % count_;
+                    if (used[slot] || std::find(placed.begin(), placed.end(), slot) != placed.end())
+                    {
+                        ok = false;
+                        break;
+                    }
+                    placed.push_back(slot);
+                }
+                if (!ok)
+                    continue;
+                for (std::size_t k = 0; k < placed.size(); ++k)
+                {
+                    used[placed[k]] = true;
+                    slots_[placed[k]] = entries[buckets[b][k]];
+                }
+                seeds_[b] = seed;
+                break;
+            }
+        }
+    }
+
+    std::vector<uint64_t> seeds_;
+    std::vector<Entry> slots_;
+    std::size_t count_ = 0;
+};
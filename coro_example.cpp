@@ -0,0 +1,62 @@
+// 协程接口示例: 每个任务是一段顺序代码, 等待期间不占用线程
+#include <iostream>
+#include <memory>
+#include "joystick_coro.h"
+
+// 按下 0 号按钮后, 等摇杆 0 号轴推过一半
+JoystickTask chargeAndRelease(JoystickScheduler &scheduler)
+{
+    while (true)
+    {
+        uint64_t frame = co_await scheduler.buttonPressed(0);
+        std::cout << "蓄力 (帧 " << frame << ")" << std::endl;
+        float value = co_await scheduler.axisCrosses(0, 0.5f);
+        std::cout << "释放, 轴 0 = " << value << std::endl;
+    }
+}
+
+// 按下 1 号按钮后统计之后 60 帧里 0 号轴的最大值
+JoystickTask sampleWindow(JoystickScheduler &scheduler)
+{
+    while (true)
+    {
+        co_await scheduler.buttonPressed(1);
+        float peak = 0.0f;
+        for (int i = 0; i < 60; ++i)
+        {
+            const JoystickScheduler::Frame &frame = co_await scheduler.nextFrame();
+            if (!frame.axes.empty() && frame.axes[0] > peak)
+                peak = frame.axes[0];
+        }
+        std::cout << "60 帧内轴 0 最大值 " << peak << std::endl;
+    }
+}
+
+// 按下 2 号按钮退出
+JoystickTask quitOnButton(JoystickScheduler &scheduler)
+{
+    co_await scheduler.buttonPressed(2);
+    scheduler.stop();
+}
+
+int main()
+{
+    try
+    {
+        auto scheduler = std::make_shared<JoystickScheduler>();
+        JoystickOptions options;
+        options.observer = scheduler;
+        SimpleJoystick joystick(options);
+
+        chargeAndRelease(*scheduler);
+        sampleWindow(*scheduler);
+        quitOnButton(*scheduler);
+        scheduler->run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
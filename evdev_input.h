@@ -0,0 +1,220 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "joystick_ring.h"
+#include "joystick_trace.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// 键盘/鼠标的一条原始输入, 字段含义同 linux input_event
+struct EvdevEvent
+{
+    uint16_t type;  // EV_KEY / EV_REL
+    uint16_t code;  // KEY_* / BTN_* / REL_*
+    int32_t value;  // 按键: 0 释放 1 按下 2 自动重复; 相对量: 位移
+    uint32_t timestamp_ms;
+};
+
+// 通过 evdev 读取键盘和鼠标 (不需要窗口, 需要 /dev/input 的读权限)
+// 独立线程阻塞在 poll() 上, 事件放入单生产者队列后调用 notify 唤醒消费者
+class EvdevInput
+{
+public:
+    typedef std::function<void()> Notify;
+
+    // paths 为空时扫描 /dev/input/event*, 只打开键盘和鼠标, 手柄仍由 SDL 处理;
+    // tracer 不为空时记录读取线程每次唤醒读入的事件
+    EvdevInput(const std::vector<std::string> &paths, Notify notify, FrameTracer *tracer = nullptr)
+        : notify_(notify), tracer_(tracer)
+    {
+#ifdef __linux__
+        if (pipe(wake_) != 0)
+        {
+            wake_[0] = wake_[1] = -1;
+            return;
+        }
+        if (paths.empty())
+            scan();
+        else
+            for (const std::string &path : paths)
+                open(path, false);
+        if (!fds_.empty())
+            thread_ = std::thread(&EvdevInput::run, this);
+#else
+        (void)paths;
+#endif
+    }
+
+    ~EvdevInput()
+    {
+#ifdef __linux__
+        stopping_ = true;
+        if (wake_[1] >= 0)
+        {
+            char byte = 0;
+            ssize_t ignored = write(wake_[1], &byte, 1);
+            (void)ignored;
+        }
+        if (thread_.joinable())
+            thread_.join();
+        for (int fd : fds_)
+            close(fd);
+        if (wake_[0] >= 0)
+        {
+            close(wake_[0]);
+            close(wake_[1]);
+        }
+#endif
+    }
+
+    // 只允许一个消费者线程调用
+    bool pop(EvdevEvent &event)
+    {
+        return queue_.pop(event);
+    }
+
+    bool pending() const
+    {
+        return !queue_.empty();
+    }
+
+    std::size_t deviceCount() const
+    {
+        return fds_.size();
+    }
+
+    // 消费者跟不上时丢弃的事件数
+    uint64_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+#ifdef __linux__
+    static bool testBit(const unsigned long *bits, unsigned bit)
+    {
+        constexpr unsigned BITS = sizeof(unsigned long) * 8;
+        return (bits[bit / BITS] >> (bit % BITS)) & 1ul;
+    }
+
+    void scan()
+    {
+        DIR *dir = opendir("/dev/input");
+        if (!dir)
+            return;
+        while (dirent *entry = readdir(dir))
+        {
+            if (std::string(entry->d_name).compare(0, 5, "event") == 0)
+                open(std::string("/dev/input/") + entry->d_name, true);
+        }
+        closedir(dir);
+    }
+
+    // filter 为 true 时只保留键盘 (有字母键) 和鼠标 (有 X/Y 相对轴和左键)
+    void open(const std::string &path, bool filter)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        if (filter)
+        {
+            constexpr unsigned BITS = sizeof(unsigned long) * 8;
+            unsigned long key_bits[(KEY_MAX + BITS) / BITS] = {};
+            unsigned long rel_bits[(REL_MAX + BITS) / BITS] = {};
+            ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits);
+            ioctl(fd, EVIOCGBIT(EV_REL, sizeof(rel_bits)), rel_bits);
+            bool keyboard = testBit(key_bits, KEY_A) && testBit(key_bits, KEY_Z);
+            bool mouse = testBit(rel_bits, REL_X) && testBit(rel_bits, REL_Y) && testBit(key_bits, BTN_LEFT);
+            if (!keyboard && !mouse)
+            {
+                close(fd);
+                return;
+            }
+        }
+        fds_.push_back(fd);
+    }
+
+    void run()
+    {
+        std::vector<pollfd> polls(fds_.size() + 1);
+        for (std::size_t i = 0; i < fds_.size(); ++i)
+        {
+            polls[i].fd = fds_[i];
+            polls[i].events = POLLIN;
+        }
+        polls.back().fd = wake_[0];
+        polls.back().events = POLLIN;
+
+        if (tracer_)
+            tracer_->nameThread("evdev");
+        input_event buffer[64];
+        while (!stopping_)
+        {
+            if (poll(polls.data(), polls.size(), -1) <= 0)
+                continue;
+            // 读取线程不知道帧号, 只记录每次唤醒读入的事件数
+            TraceScope read_span(tracer_, "evdev_read");
+            uint64_t read_events = 0;
+            bool pushed = false;
+            for (std::size_t i = 0; i < fds_.size(); ++i)
+            {
+                if (polls[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+                {
+                    polls[i].fd = -1; // 设备拔出, 不再轮询
+                    continue;
+                }
+                if (!(polls[i].revents & POLLIN))
+                    continue;
+                ssize_t bytes;
+                while ((bytes = read(fds_[i], buffer, sizeof(buffer))) > 0)
+                {
+                    uint32_t now_ms = SDL_GetTicks();
+                    for (std::size_t k = 0; k < static_cast<std::size_t>(bytes) / sizeof(input_event); ++k)
+                    {
+                        if (buffer[k].type != EV_KEY && buffer[k].type != EV_REL)
+                            continue;
+                        EvdevEvent event;
+                        event.type = buffer[k].type;
+                        event.code = buffer[k].code;
+                        event.value = buffer[k].value;
+                        event.timestamp_ms = now_ms;
+                        ++read_events;
+                        if (queue_.push(event))
+                            pushed = true;
+                        else
+                            dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            if (read_events == 0)
+                read_span.cancel();
+            read_span.setArg(read_events);
+            if (pushed && notify_)
+                notify_();
+        }
+    }
+
+    int wake_[2] = {-1, -1};
+#endif
+
+    Notify notify_;
+    FrameTracer *tracer_;
+    std::vector<int> fds_;
+    SpscRing<EvdevEvent, 1024> queue_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic_bool stopping_{false};
+    std::thread thread_;
+};
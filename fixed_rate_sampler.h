@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include "joystick_core.h"
+
+// 一个采样点: tick 为节拍序号, 跳过的节拍不产生样本
+struct FixedRateSample
+{
+    uint64_t tick = 0;
+    uint64_t deadline_ns = 0; // 预定时刻 (CLOCK_MONOTONIC)
+    uint64_t sampled_ns = 0;  // 实际采样时刻
+    uint32_t missed = 0;      // 本样本之前错过的节拍数
+    JoystickData data;
+};
+
+// 按固定频率在调用线程上产生快照: 用绝对时刻睡眠, 误差不累积;
+// 处理超过一个周期时跳过错过的节拍并计数, 之后仍对齐到原来的节拍网格
+class FixedRateSampler
+{
+public:
+    // interpolate 为 true 时, 摇杆轴取滤波器按速度估计的节拍时刻的值 (见 getPredictedData), 而不是最近一个事件的值
+    FixedRateSampler(SimpleJoystick &joystick, double rate_hz, bool interpolate = false)
+        : joystick_(joystick),
+          period_ns_(static_cast<uint64_t>(1e9 / (rate_hz > 0.0 ? rate_hz : 1.0))),
+          interpolate_(interpolate),
+          missed_(joystick.metrics().counter("joystick_sampler_missed_deadlines_total", "Sampler ticks skipped because the consumer overran")),
+          lateness_ns_(joystick.metrics().histogram("joystick_sampler_lateness_ns", "Sampler wakeup delay after the tick deadline, in ns"))
+    {
+        reset();
+    }
+
+    // 从当前时刻重新开始节拍 (如暂停恢复后), 不计入错过
+    void reset()
+    {
+        next_ns_ = now() + period_ns_;
+    }
+
+    // 阻塞到下一个节拍并采样
+    void next(FixedRateSample &out)
+    {
+        uint64_t deadline = next_ns_;
+        sleepUntil(deadline);
+        uint64_t sampled = now();
+
+        // 醒来时已经过了后面的节拍: 样本归到最近一个已到的节拍, 中间的节拍计为错过
+        uint64_t late = sampled > deadline ? sampled - deadline : 0;
+        uint64_t skipped = late / period_ns_;
+        deadline += skipped * period_ns_;
+        tick_ += skipped;
+        next_ns_ = deadline + period_ns_;
+        lateness_ns_.observe(late - skipped * period_ns_);
+        if (skipped)
+            missed_.inc(skipped);
+
+        out.tick = tick_++;
+        out.deadline_ns = deadline;
+        out.sampled_ns = sampled;
+        out.missed = static_cast<uint32_t>(skipped);
+        out.data = interpolate_ ? joystick_.getPredictedData() : joystick_.getData();
+    }
+
+    uint64_t periodNs() const
+    {
+        return period_ns_;
+    }
+
+    static uint64_t now()
+    {
+#ifdef __linux__
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + static_cast<uint64_t>(ts.tv_nsec);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+private:
+    static void sleepUntil(uint64_t deadline_ns)
+    {
+#ifdef __linux__
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000u);
+        ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000u);
+        // 被信号打断时继续睡到同一个绝对时刻
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        {
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline_ns)));
+#endif
+    }
+
+    SimpleJoystick &joystick_;
+    uint64_t period_ns_;
+    bool interpolate_;
+    MetricCounter &missed_;
+    MetricHistogram &lateness_ns_;
+    uint64_t next_ns_ = 0;
+    uint64_t tick_ = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// 帧序号 + 等待: 写者每发布一帧调用一次 publish, 所有等待中的读者被一次 futex 唤醒后直接返回,
+// 不再竞争任何锁; 没有读者在等时发布只是一次原子写
+class FrameSignal
+{
+public:
+    uint64_t sequence() const
+    {
+        return __atomic_load_n(&seq_, __ATOMIC_ACQUIRE);
+    }
+
+    // 只由一个线程调用
+    void publish(uint64_t seq)
+    {
+        __atomic_store_n(&seq_, seq, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+        __atomic_store_n(&word_, static_cast<uint32_t>(seq), __ATOMIC_SEQ_CST);
+        wake();
+#else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cv_.notify_all();
+#endif
+    }
+
+    // 唤醒所有等待者而不改变序号 (如停止时), 等待者按超时处理
+    void wakeAll()
+    {
+#ifdef __linux__
+        // 先改变 futex 字, 正在进入等待的读者不会睡下去; 之后改回, 期间有 publish 写过则保留它的值
+        uint32_t changed = __atomic_add_fetch(&word_, 0x80000000u, __ATOMIC_SEQ_CST);
+        wake();
+        __atomic_compare_exchange_n(&word_, &changed, static_cast<uint32_t>(sequence()), false, __ATOMIC_SEQ_CST,
+                                    __ATOMIC_SEQ_CST);
+#else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++spurious_;
+        }
+        cv_.notify_all();
+#endif
+    }
+
+    // 序号不等于 last_seq 时立即返回当前序号; 否则最多阻塞 timeout。
+    // 返回值等于 last_seq 表示超时或被 wakeAll 唤醒
+    uint64_t wait(uint64_t last_seq, std::chrono::milliseconds timeout)
+    {
+        uint64_t seq = sequence();
+        if (seq != last_seq || timeout.count() <= 0)
+            return seq;
+#ifdef __linux__
+        // 登记等待者后由内核比较 futex 字, 与 publish 之间不会漏掉唤醒
+        __atomic_add_fetch(&waiters_, 1, __ATOMIC_SEQ_CST);
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000) * 1000000L;
+        syscall(SYS_futex, &word_, FUTEX_WAIT_PRIVATE, static_cast<uint32_t>(last_seq), &ts, nullptr, 0);
+        __atomic_sub_fetch(&waiters_, 1, __ATOMIC_SEQ_CST);
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t spurious = spurious_;
+        cv_.wait_for(lock, timeout, [&]
+                     { return sequence() != last_seq || spurious_ != spurious; });
+#endif
+        return sequence();
+    }
+
+private:
+#ifdef __linux__
+    void wake()
+    {
+        if (__atomic_load_n(&waiters_, __ATOMIC_SEQ_CST) > 0)
+            syscall(SYS_futex, &word_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    uint32_t word_ = 0; // futex 字: 序号的低 32 位
+    uint32_t waiters_ = 0;
+#else
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t spurious_ = 0;
+#endif
+    uint64_t seq_ = 0;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 震动/LED 输出后端; 默认直接调用 SDL, 测试时可换成 RecordingHapticBackend
+// 只在事件线程上调用; 没有打开的设备时 joystick 为空
+class HapticBackend
+{
+public:
+    virtual ~HapticBackend() {}
+    virtual bool rumble(SDL_Joystick *joystick, uint16_t low, uint16_t high, uint32_t duration_ms) = 0;
+    virtual bool rumbleTriggers(SDL_Joystick *joystick, uint16_t left, uint16_t right, uint32_t duration_ms) = 0;
+    virtual bool setLed(SDL_Joystick *joystick, uint8_t red, uint8_t green, uint8_t blue) = 0;
+};
+
+class SdlHapticBackend : public HapticBackend
+{
+public:
+    bool rumble(SDL_Joystick *joystick, uint16_t low, uint16_t high, uint32_t duration_ms) override
+    {
+#if SDL_VERSION_ATLEAST(2, 0, 9)
+        return joystick && SDL_JoystickRumble(joystick, low, high, duration_ms) == 0;
+#else
+        (void)joystick, (void)low, (void)high, (void)duration_ms;
+        return false;
+#endif
+    }
+
+    bool rumbleTriggers(SDL_Joystick *joystick, uint16_t left, uint16_t right, uint32_t duration_ms) override
+    {
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+        return joystick && SDL_JoystickRumbleTriggers(joystick, left, right, duration_ms) == 0;
+#else
+        (void)joystick, (void)left, (void)right, (void)duration_ms;
+        return false;
+#endif
+    }
+
+    bool setLed(SDL_Joystick *joystick, uint8_t red, uint8_t green, uint8_t blue) override
+    {
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+        return joystick && SDL_JoystickSetLED(joystick, red, green, blue) == 0;
+#else
+        (void)joystick, (void)red, (void)green, (void)blue;
+        return false;
+#endif
+    }
+};
+
+// 记录所有输出调用, 用于对输出序列做断言
+class RecordingHapticBackend : public HapticBackend
+{
+public:
+    enum Kind
+    {
+        RUMBLE,
+        RUMBLE_TRIGGERS,
+        LED
+    };
+
+    struct Call
+    {
+        Kind kind;
+        uint16_t a;           // low / left / red
+        uint16_t b;           // high / right / green
+        uint32_t duration_ms; // LED 调用时为 blue
+    };
+
+    bool rumble(SDL_Joystick *, uint16_t low, uint16_t high, uint32_t duration_ms) override
+    {
+        record(RUMBLE, low, high, duration_ms);
+        return true;
+    }
+
+    bool rumbleTriggers(SDL_Joystick *, uint16_t left, uint16_t right, uint32_t duration_ms) override
+    {
+        record(RUMBLE_TRIGGERS, left, right, duration_ms);
+        return true;
+    }
+
+    bool setLed(SDL_Joystick *, uint8_t red, uint8_t green, uint8_t blue) override
+    {
+        record(LED, red, green, blue);
+        return true;
+    }
+
+    std::vector<Call> calls() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_;
+    }
+
+private:
+    void record(Kind kind, uint16_t a, uint16_t b, uint32_t c)
+    {
+        Call call;
+        call.kind = kind;
+        call.a = a;
+        call.b = b;
+        call.duration_ms = c;
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.push_back(call);
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Call> calls_;
+};
+
+// 输出请求的无锁邮箱: 每种输出一个 64 位槽位加一个脏位,
+// 生产者覆盖槽位, 事件线程每轮取走脏位并下发最新值; 连续请求自然合并为最后一次
+class HapticMailbox
+{
+public:
+    enum Channel
+    {
+        RUMBLE = 0,
+        RUMBLE_TRIGGERS = 1,
+        LED = 2,
+        CHANNELS = 3
+    };
+
+    // 返回 true 表示覆盖了一个尚未下发的请求
+    bool post(Channel channel, uint64_t value)
+    {
+        slots_[channel].store(value, std::memory_order_release);
+        uint32_t bit = 1u << channel;
+        return (dirty_.fetch_or(bit, std::memory_order_acq_rel) & bit) != 0;
+    }
+
+    // 重新下发某个通道的最后一个值 (设备切换后恢复 LED)
+    void repost(Channel channel)
+    {
+        dirty_.fetch_or(1u << channel, std::memory_order_acq_rel);
+    }
+
+    uint32_t take()
+    {
+        return dirty_.exchange(0, std::memory_order_acq_rel);
+    }
+
+    bool pending() const
+    {
+        return dirty_.load(std::memory_order_acquire) != 0;
+    }
+
+    uint64_t value(Channel channel) const
+    {
+        return slots_[channel].load(std::memory_order_acquire);
+    }
+
+    static uint64_t packRumble(uint16_t a, uint16_t b, uint32_t duration_ms)
+    {
+        return static_cast<uint64_t>(a) | (static_cast<uint64_t>(b) << 16) | (static_cast<uint64_t>(duration_ms) << 32);
+    }
+
+    static uint64_t packLed(uint8_t red, uint8_t green, uint8_t blue)
+    {
+        return static_cast<uint64_t>(red) | (static_cast<uint64_t>(green) << 8) | (static_cast<uint64_t>(blue) << 16);
+    }
+
+private:
+    std::atomic<uint64_t> slots_[CHANNELS] = {};
+    std::atomic<uint32_t> dirty_{0};
+};
@@ -0,0 +1,276 @@
+#include "joystick_capi.h"
+#include "joystick_core.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+
+namespace
+{
+    thread_local char last_error[256] = "";
+
+    void setError(const char *message)
+    {
+        std::snprintf(last_error, sizeof(last_error), "%s", message);
+    }
+
+    // 把快照写入共享区并转发回调; 只有事件线程写, 读者按 seq 重试
+    class CapiObserver : public JoystickObserver
+    {
+    public:
+        CapiObserver()
+        {
+            std::memset(&shared_, 0, sizeof(shared_));
+            shared_.snapshot.orientation[0] = 1.0f;
+        }
+
+        void capture(const JoystickData &data) override
+        {
+            sj_snapshot &s = captured_;
+            s.frame_id = data.frame_id;
+            s.num_axes = static_cast<uint8_t>(std::min<std::size_t>(data.axes.size(), SJ_MAX_AXES));
+            s.num_buttons = static_cast<uint8_t>(std::min<std::size_t>(data.buttons.size(), SJ_MAX_BUTTONS));
+            s.num_hats = static_cast<uint8_t>(std::min<std::size_t>(data.num_hats, SJ_MAX_HATS));
+            s.num_triggers = static_cast<uint8_t>(std::min<std::size_t>(data.num_triggers, SJ_MAX_TRIGGERS));
+            s.standard_layout = data.standard_layout;
+            s.has_orientation = data.has_orientation;
+            s.mouse_buttons = data.mouse_buttons;
+            s.buttons = 0;
+            for (std::size_t i = 0; i < s.num_buttons; ++i)
+            {
+                if (data.buttons[i])
+                    s.buttons |= uint64_t(1) << i;
+            }
+            std::memset(s.axes, 0, sizeof(s.axes));
+            std::memcpy(s.axes, data.axes.data(), s.num_axes * sizeof(float));
+            for (std::size_t i = 0; i < SJ_MAX_TRIGGERS; ++i)
+                s.triggers[i] = i < data.triggers.size() ? data.triggers[i] : 0.0f;
+            for (std::size_t i = 0; i < SJ_MAX_HATS; ++i)
+                s.hats[i] = i < data.hats.size() ? data.hats[i] : 0;
+            std::memcpy(s.orientation, data.orientation.data(), sizeof(s.orientation));
+            std::memcpy(s.keys, data.keys.data(), sizeof(s.keys));
+
+            uint32_t seq = __atomic_load_n(&shared_.seq, __ATOMIC_RELAXED);
+            __atomic_store_n(&shared_.seq, seq + 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            std::memcpy(&shared_.snapshot, &s, sizeof(s));
+            __atomic_store_n(&shared_.seq, seq + 2, __ATOMIC_RELEASE);
+        }
+
+        void published() override
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (frame_callback_)
+                frame_callback_(&captured_, frame_user_);
+        }
+
+        void connection(const ConnectionEvent &event) override
+        {
+            active_id_ = event.state == ConnectionState::DISCONNECTED ? -1 : event.instance_id;
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (connection_callback_)
+                connection_callback_(static_cast<sj_connection_state>(event.state), event.instance_id, event.guid,
+                                     connection_user_);
+        }
+
+        // 写者写得很快, 连续撞上更新的次数有限; 超过上限 (写者被抢占) 时交给调用方决定
+        bool read(sj_snapshot &out) const
+        {
+            constexpr int MAX_RETRIES = 1024;
+            for (int i = 0; i < MAX_RETRIES; ++i)
+            {
+                uint32_t before = __atomic_load_n(&shared_.seq, __ATOMIC_ACQUIRE);
+                if (before & 1u)
+                    continue;
+                std::memcpy(&out, &shared_.snapshot, sizeof(out));
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&shared_.seq, __ATOMIC_RELAXED) == before)
+                    return true;
+            }
+            return false;
+        }
+
+        const sj_shared_snapshot &shared() const
+        {
+            return shared_;
+        }
+
+        void setFrameCallback(sj_frame_callback callback, void *user)
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            frame_callback_ = callback;
+            frame_user_ = user;
+        }
+
+        void setConnectionCallback(sj_connection_callback callback, void *user)
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            connection_callback_ = callback;
+            connection_user_ = user;
+        }
+
+        SDL_JoystickID activeId() const
+        {
+            return active_id_;
+        }
+
+    private:
+        sj_shared_snapshot shared_;
+        sj_snapshot captured_ = sj_snapshot(); // 事件线程上的工作副本, 回调直接使用
+        std::atomic<SDL_JoystickID> active_id_{-1};
+        std::mutex callback_mutex_; // 回调期间持有, 注销返回后不会再被调用
+        sj_frame_callback frame_callback_ = nullptr;
+        void *frame_user_ = nullptr;
+        sj_connection_callback connection_callback_ = nullptr;
+        void *connection_user_ = nullptr;
+    };
+}
+
+struct sj_joystick
+{
+    std::shared_ptr<CapiObserver> observer;
+    std::unique_ptr<SimpleJoystick> joystick;
+};
+
+extern "C" {
+
+void sj_options_init(sj_options *options)
+{
+    if (!options)
+        return;
+    std::memset(options, 0, sizeof(*options));
+    options->size = sizeof(*options);
+}
+
+sj_status sj_open(const sj_options *options, sj_joystick **out)
+{
+    if (!out || (options && options->size < sizeof(options->size)))
+    {
+        setError("invalid argument");
+        return SJ_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+    try
+    {
+        JoystickOptions cpp_options;
+        if (options)
+        {
+            // 只读调用方结构体里有的字段 (旧版本的结构体更短), 其余保持默认值
+            sj_options given;
+            sj_options_init(&given);
+            std::memcpy(&given, options, std::min<std::size_t>(options->size, sizeof(given)));
+            cpp_options.game_controller = given.game_controller != 0;
+            if (given.mappings_file)
+                cpp_options.mappings_file = given.mappings_file;
+            cpp_options.sensors = given.sensors != 0;
+            cpp_options.orientation = given.orientation != 0;
+            cpp_options.keyboard_mouse = given.keyboard_mouse != 0;
+        }
+        std::unique_ptr<sj_joystick> handle(new sj_joystick);
+        handle->observer = std::make_shared<CapiObserver>();
+        cpp_options.observer = handle->observer;
+        handle->joystick.reset(new SimpleJoystick(cpp_options));
+        *out = handle.release();
+        return SJ_OK;
+    }
+    catch (const std::exception &e)
+    {
+        setError(e.what());
+    }
+    catch (...)
+    {
+        setError("unknown error");
+    }
+    return SJ_ERROR;
+}
+
+void sj_close(sj_joystick *joystick)
+{
+    try
+    {
+        delete joystick;
+    }
+    catch (...)
+    {
+    }
+}
+
+const char *sj_last_error(void)
+{
+    return last_error;
+}
+
+sj_status sj_read(sj_joystick *joystick, sj_snapshot *out)
+{
+    if (!joystick || !out)
+        return SJ_INVALID_ARGUMENT;
+    return joystick->observer->read(*out) ? SJ_OK : SJ_BUSY;
+}
+
+const sj_shared_snapshot *sj_shared(sj_joystick *joystick)
+{
+    return joystick ? &joystick->observer->shared() : nullptr;
+}
+
+sj_status sj_set_frame_callback(sj_joystick *joystick, sj_frame_callback callback, void *user)
+{
+    if (!joystick)
+        return SJ_INVALID_ARGUMENT;
+    joystick->observer->setFrameCallback(callback, user);
+    return SJ_OK;
+}
+
+sj_status sj_set_connection_callback(sj_joystick *joystick, sj_connection_callback callback, void *user)
+{
+    if (!joystick)
+        return SJ_INVALID_ARGUMENT;
+    joystick->observer->setConnectionCallback(callback, user);
+    return SJ_OK;
+}
+
+sj_status sj_enumerate(sj_joystick *joystick, sj_device_info *out, size_t max, size_t *count)
+{
+    if (!joystick || (!out && max > 0))
+        return SJ_INVALID_ARGUMENT;
+    int total = SDL_NumJoysticks();
+    if (total < 0)
+    {
+        setError(SDL_GetError());
+        return SJ_ERROR;
+    }
+    SDL_JoystickID active = joystick->observer->activeId();
+    std::size_t filled = 0;
+    for (int i = 0; i < total && filled < max; ++i)
+    {
+        sj_device_info &info = out[filled++];
+        std::memset(&info, 0, sizeof(info));
+        info.instance_id = SDL_JoystickGetDeviceInstanceID(i);
+        info.active = info.instance_id == active;
+        info.game_controller = SDL_IsGameController(i) ? 1 : 0;
+        SDL_JoystickGetGUIDString(SDL_JoystickGetDeviceGUID(i), info.guid, sizeof(info.guid));
+        const char *name = SDL_JoystickNameForIndex(i);
+        std::snprintf(info.name, sizeof(info.name), "%s", name ? name : "");
+    }
+    if (count)
+        *count = static_cast<std::size_t>(total);
+    return SJ_OK;
+}
+
+sj_status sj_rumble(sj_joystick *joystick, uint16_t low_frequency, uint16_t high_frequency, uint32_t duration_ms)
+{
+    if (!joystick)
+        return SJ_INVALID_ARGUMENT;
+    joystick->joystick->rumble(low_frequency, high_frequency, duration_ms);
+    return SJ_OK;
+}
+
+sj_status sj_set_led(sj_joystick *joystick, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (!joystick)
+        return SJ_INVALID_ARGUMENT;
+    joystick->joystick->setLed(red, green, blue);
+    return SJ_OK;
+}
+
+}
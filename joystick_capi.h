@@ -0,0 +1,119 @@
+#pragma once
+
+// joystick_core 的 C 接口: 不透明句柄 + 定长 POD 快照, 供 C 和其他语言 (FFI) 调用
+// 接口内不抛出异常; 打开之后的读取、回调和枚举都不分配内存
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SJ_MAX_AXES 16
+#define SJ_MAX_BUTTONS 64
+#define SJ_MAX_HATS 4
+#define SJ_MAX_TRIGGERS 4
+
+typedef enum sj_status
+{
+    SJ_OK = 0,
+    SJ_ERROR = -1,            // 详细信息见 sj_last_error()
+    SJ_INVALID_ARGUMENT = -2,
+    SJ_BUSY = -3              // 快照正在更新, 重试次数用完
+} sj_status;
+
+typedef enum sj_connection_state
+{
+    SJ_DISCONNECTED = 0,
+    SJ_CONNECTED = 1,
+    SJ_FAILOVER = 2 // 原设备拔出, 已切换到备用设备
+} sj_connection_state;
+
+typedef struct sj_joystick sj_joystick;
+
+// 先用 sj_options_init() 填默认值; size 用于以后追加字段时保持二进制兼容:
+// 库只读取 size 覆盖的字段, 旧程序传入的较短结构体中没有的字段取默认值
+typedef struct sj_options
+{
+    uint32_t size;
+    int32_t game_controller;   // 非 0 时按 SDL 标准手柄布局输出
+    const char *mappings_file; // gamecontrollerdb.txt 格式, 可为 NULL
+    int32_t sensors;
+    int32_t orientation;
+    int32_t keyboard_mouse;
+} sj_options;
+
+// 一帧的全部状态, 超出上限的轴/按钮被截断 (num_* 为截断后的个数)
+typedef struct sj_snapshot
+{
+    uint64_t frame_id;
+    uint8_t num_axes;
+    uint8_t num_buttons;
+    uint8_t num_hats;
+    uint8_t num_triggers;
+    uint8_t standard_layout;
+    uint8_t has_orientation;
+    uint8_t mouse_buttons; // bit0 左 bit1 右 bit2 中
+    uint8_t reserved;
+    uint64_t buttons;      // bit i 为第 i 个按钮
+    float axes[SJ_MAX_AXES];
+    float triggers[SJ_MAX_TRIGGERS];
+    float orientation[4];  // w, x, y, z
+    uint8_t hats[SJ_MAX_HATS];
+    uint32_t reserved2;
+    uint64_t keys[4];      // evdev KEY_* 0-255 位图
+} sj_snapshot;
+
+// 共享快照区: 事件线程写入时 seq 为奇数, 写完后为偶数
+// 直接读取时: 原子读 seq (acquire) 为偶数 -> 拷贝 snapshot -> 再读 seq 不变才有效; 或直接用 sj_read()
+typedef struct sj_shared_snapshot
+{
+    uint32_t seq;
+    uint32_t reserved;
+    sj_snapshot snapshot;
+} sj_shared_snapshot;
+
+typedef struct sj_device_info
+{
+    int32_t instance_id;
+    uint8_t active;          // 当前正在读取的设备
+    uint8_t game_controller; // SDL 能按标准布局映射
+    uint8_t reserved[2];
+    char guid[33];
+    char name[128];
+} sj_device_info;
+
+// 每个新帧发布后在事件线程上调用; 回调内不能阻塞, 也不能调用 sj_close() 或重新注册回调
+typedef void (*sj_frame_callback)(const sj_snapshot *snapshot, void *user);
+// guid 只在回调期间有效
+typedef void (*sj_connection_callback)(sj_connection_state state, int32_t instance_id, const char *guid, void *user);
+
+void sj_options_init(sj_options *options);
+
+// options 为 NULL 时使用默认值
+sj_status sj_open(const sj_options *options, sj_joystick **out);
+void sj_close(sj_joystick *joystick);
+
+// 本线程最近一次失败的说明
+const char *sj_last_error(void);
+
+// 把最新一帧拷贝到调用方的缓冲, 可在任意线程调用, 不加锁
+sj_status sj_read(sj_joystick *joystick, sj_snapshot *out);
+
+// 共享快照区, 在 sj_close() 之前一直有效
+const sj_shared_snapshot *sj_shared(sj_joystick *joystick);
+
+// 传 NULL 取消注册; 返回后旧回调不会再被调用
+sj_status sj_set_frame_callback(sj_joystick *joystick, sj_frame_callback callback, void *user);
+sj_status sj_set_connection_callback(sj_joystick *joystick, sj_connection_callback callback, void *user);
+
+// 枚举已插入的设备, 最多写 max 个; count 返回设备总数
+sj_status sj_enumerate(sj_joystick *joystick, sj_device_info *out, size_t max, size_t *count);
+
+// 输出, 语义同 SimpleJoystick::rumble() / setLed()
+sj_status sj_rumble(sj_joystick *joystick, uint16_t low_frequency, uint16_t high_frequency, uint32_t duration_ms);
+sj_status sj_set_led(sj_joystick *joystick, uint8_t red, uint8_t green, uint8_t blue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,544 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "axis_filter.h"
+#include "button_debouncer.h"
+#include "stick_deadzone.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// 动作绑定的输入来源
+enum class InputSource : uint8_t
+{
+    JOYSTICK_BUTTON,   // 原始按钮索引, 只在非标准布局下匹配
+    CONTROLLER_BUTTON, // SDL_GameControllerButton, 只在标准布局下匹配
+    KEY,               // evdev KEY_* 编码
+    MOUSE_BUTTON       // 0 左 1 右 2 中
+};
+
+// 输入到命令的绑定, 由应用解释 (示例程序中即按钮命令)
+struct ConfigBinding
+{
+    InputSource source;
+    int code;
+    int command; // 0-63
+};
+
+// 可热加载的运行参数; 文件中没有出现的键保持启动时的值
+struct JoystickConfig
+{
+    float deadzone = 0.1f;          // 不属于摇杆对的轴的单轴死区
+    float trigger_deadzone = 0.02f; // 扳机静止端的死区
+    int poll_interval_ms = 60;
+    AxisFilterConfig axis_filter;
+    std::vector<StickPairConfig> stick_pairs; // 为空时使用默认的两对
+    DebounceMode debounce_mode = DebounceMode::LEADING_EDGE;
+    uint32_t debounce_ms = 20;
+    std::vector<ConfigBinding> bindings; // 为空时应用使用内置绑定
+};
+
+namespace joystick_config_detail
+{
+    struct Value
+    {
+        bool is_string = false;
+        std::string text; // 字符串内容或数字/布尔的原文
+    };
+
+    inline std::string trim(const std::string &s)
+    {
+        std::size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return std::string();
+        std::size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    inline bool toNumber(const Value &value, double &out)
+    {
+        if (value.is_string || value.text.empty())
+            return false;
+        char *end = nullptr;
+        out = std::strtod(value.text.c_str(), &end);
+        return *end == '\0';
+    }
+
+    // 把 "key = value" 的一个键写入 config; 返回 false 时 error 为原因
+    class Interpreter
+    {
+    public:
+        explicit Interpreter(JoystickConfig &config)
+            : config_(config)
+        {
+        }
+
+        bool section(const std::string &name, std::string &error)
+        {
+            section_ = name;
+            if (name.compare(0, 6, "stick.") == 0 && name.size() > 6)
+            {
+                // 文件中第一次出现摇杆对时替换掉原有的全部摇杆对
+                if (!sticks_seen_)
+                    config_.stick_pairs.clear();
+                sticks_seen_ = true;
+                config_.stick_pairs.push_back(StickPairConfig());
+                return true;
+            }
+            if (name == "filter" || name == "debounce")
+                return true;
+            if (name == "bindings")
+            {
+                if (!bindings_seen_)
+                    config_.bindings.clear();
+                bindings_seen_ = true;
+                return true;
+            }
+            error = "unknown section [" + name + "]";
+            return false;
+        }
+
+        bool set(const std::string &key, const Value &value, std::string &error)
+        {
+            bool ok;
+            if (section_.empty())
+                ok = setTop(key, value);
+            else if (section_ == "filter")
+                ok = setFilter(key, value);
+            else if (section_ == "debounce")
+                ok = setDebounce(key, value);
+            else if (section_ == "bindings")
+                ok = setBinding(key, value);
+            else
+                ok = setStick(config_.stick_pairs.back(), key, value);
+            if (!ok)
+                error = "bad key or value: " + key;
+            return ok;
+        }
+
+    private:
+        // 转换前检查范围: 超出目标类型的值 (以及 nan/inf、整数键的小数) 直接拒绝, 不做未定义的转换
+        template <typename T>
+        static bool number(const Value &value, T &out)
+        {
+            double parsed;
+            if (!toNumber(value, parsed) || !std::isfinite(parsed))
+                return false;
+            if (parsed < static_cast<double>(std::numeric_limits<T>::lowest()) ||
+                parsed > static_cast<double>(std::numeric_limits<T>::max()))
+                return false;
+            if (std::is_integral<T>::value && parsed != std::floor(parsed))
+                return false;
+            out = static_cast<T>(parsed);
+            return true;
+        }
+
+        bool setTop(const std::string &key, const Value &value)
+        {
+            if (key == "deadzone")
+                return number(value, config_.deadzone);
+            if (key == "trigger_deadzone")
+                return number(value, config_.trigger_deadzone);
+            if (key == "poll_interval_ms")
+                return number(value, config_.poll_interval_ms);
+            return false;
+        }
+
+        bool setFilter(const std::string &key, const Value &value)
+        {
+            AxisFilterConfig &f = config_.axis_filter;
+            if (key == "mode")
+            {
+                if (!value.is_string)
+                    return false;
+                if (value.text == "off")
+                    f.mode = AxisFilterMode::OFF;
+                else if (value.text == "one-euro")
+                    f.mode = AxisFilterMode::ONE_EURO;
+                else if (value.text == "kalman")
+                    f.mode = AxisFilterMode::KALMAN;
+                else
+                    return false;
+                return true;
+            }
+            if (key == "min_cutoff")
+                return number(value, f.min_cutoff);
+            if (key == "beta")
+                return number(value, f.beta);
+            if (key == "derivative_cutoff")
+                return number(value, f.derivative_cutoff);
+            if (key == "process_noise")
+                return number(value, f.process_noise);
+            if (key == "measurement_noise")
+                return number(value, f.measurement_noise);
+            if (key == "max_prediction_ms")
+                return number(value, f.max_prediction_ms);
+            return false;
+        }
+
+        bool setDebounce(const std::string &key, const Value &value)
+        {
+            if (key == "mode")
+            {
+                if (!value.is_string)
+                    return false;
+                if (value.text == "off")
+                    config_.debounce_mode = DebounceMode::OFF;
+                else if (value.text == "leading-edge")
+                    config_.debounce_mode = DebounceMode::LEADING_EDGE;
+                else if (value.text == "integrating")
+                    config_.debounce_mode = DebounceMode::INTEGRATING;
+                else
+                    return false;
+                return true;
+            }
+            int window_ms;
+            if (key == "window_ms" && number(value, window_ms) && window_ms >= 0)
+            {
+                config_.debounce_ms = static_cast<uint32_t>(window_ms);
+                return true;
+            }
+            return false;
+        }
+
+        static bool setStick(StickPairConfig &pair, const std::string &key, const Value &value)
+        {
+            if (key == "shape")
+            {
+                if (!value.is_string)
+                    return false;
+                if (value.text == "axial")
+                    pair.shape = DeadzoneShape::AXIAL;
+                else if (value.text == "radial")
+                    pair.shape = DeadzoneShape::RADIAL;
+                else if (value.text == "scaled-radial")
+                    pair.shape = DeadzoneShape::SCALED_RADIAL;
+                else if (value.text == "bowtie")
+                    pair.shape = DeadzoneShape::BOWTIE;
+                else
+                    return false;
+                return true;
+            }
+            if (key == "x_axis")
+                return number(value, pair.x_axis);
+            if (key == "y_axis")
+                return number(value, pair.y_axis);
+            if (key == "inner")
+                return number(value, pair.inner);
+            if (key == "outer")
+                return number(value, pair.outer);
+            if (key == "anti_deadzone")
+                return number(value, pair.anti_deadzone);
+            if (key == "bowtie")
+                return number(value, pair.bowtie);
+            return false;
+        }
+
+        // 键为 "来源.编号", 如 button.0 / controller.2 / key.45 / mouse.0, 值为命令号
+        bool setBinding(const std::string &key, const Value &value)
+        {
+            std::size_t dot = key.find('.');
+            if (dot == std::string::npos)
+                return false;
+            std::string source = key.substr(0, dot);
+            ConfigBinding binding;
+            if (source == "button")
+                binding.source = InputSource::JOYSTICK_BUTTON;
+            else if (source == "controller")
+                binding.source = InputSource::CONTROLLER_BUTTON;
+            else if (source == "key")
+                binding.source = InputSource::KEY;
+            else if (source == "mouse")
+                binding.source = InputSource::MOUSE_BUTTON;
+            else
+                return false;
+            Value code;
+            code.text = key.substr(dot + 1);
+            if (!number(code, binding.code) || !number(value, binding.command))
+                return false;
+            config_.bindings.push_back(binding);
+            return true;
+        }
+
+        JoystickConfig &config_;
+        std::string section_;
+        bool sticks_seen_ = false;
+        bool bindings_seen_ = false;
+    };
+
+    inline bool sameFilter(const AxisFilterConfig &a, const AxisFilterConfig &b)
+    {
+        return a.mode == b.mode && a.min_cutoff == b.min_cutoff && a.beta == b.beta &&
+               a.derivative_cutoff == b.derivative_cutoff && a.process_noise == b.process_noise &&
+               a.measurement_noise == b.measurement_noise && a.max_prediction_ms == b.max_prediction_ms;
+    }
+
+    inline bool sameStickPairs(const std::vector<StickPairConfig> &a, const std::vector<StickPairConfig> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].x_axis != b[i].x_axis || a[i].y_axis != b[i].y_axis || a[i].shape != b[i].shape ||
+                a[i].inner != b[i].inner || a[i].outer != b[i].outer || a[i].anti_deadzone != b[i].anti_deadzone ||
+                a[i].bowtie != b[i].bowtie)
+                return false;
+        }
+        return true;
+    }
+
+    // 截止频率为 0 时 One-Euro 的平滑系数为 0, 轴值冻结; 测量噪声为 0 时卡尔曼增益除以 0
+    inline bool validFilter(const AxisFilterConfig &filter, std::string &error)
+    {
+        if (!(filter.min_cutoff > 0.0f))
+            error = "min_cutoff must be positive";
+        else if (!(filter.derivative_cutoff > 0.0f))
+            error = "derivative_cutoff must be positive";
+        else if (!(filter.beta >= 0.0f))
+            error = "beta must be non-negative";
+        else if (!(filter.process_noise >= 0.0f))
+            error = "process_noise must be non-negative";
+        else if (!(filter.measurement_noise > 0.0f))
+            error = "measurement_noise must be positive";
+        else if (!(filter.max_prediction_ms >= 0.0f && filter.max_prediction_ms <= 1000.0f))
+            error = "max_prediction_ms must be in [0, 1000]";
+        return error.empty();
+    }
+
+    inline bool validate(const JoystickConfig &config, std::string &error)
+    {
+        if (!(config.deadzone >= 0.0f && config.deadzone < 1.0f))
+            error = "deadzone must be in [0, 1)";
+        else if (!(config.trigger_deadzone >= 0.0f && config.trigger_deadzone < 1.0f))
+            error = "trigger_deadzone must be in [0, 1)";
+        else if (config.poll_interval_ms < 1 || config.poll_interval_ms > 1000)
+            error = "poll_interval_ms must be in [1, 1000]";
+        else if (config.debounce_ms > 1000)
+            error = "debounce window_ms must be at most 1000";
+        else if (!validFilter(config.axis_filter, error))
+            error = "filter: " + error;
+        for (const StickPairConfig &pair : config.stick_pairs)
+        {
+            if (!error.empty())
+                break;
+            if (pair.x_axis < 0 || pair.y_axis < 0 || pair.x_axis == pair.y_axis)
+                error = "stick axes must be two different non-negative indices";
+            else if (!(pair.inner >= 0.0f && pair.inner < pair.outer && pair.outer <= 1.0f))
+                error = "stick deadzone needs 0 <= inner < outer <= 1";
+            else if (!(pair.anti_deadzone >= 0.0f && pair.anti_deadzone < 1.0f))
+                error = "stick anti_deadzone must be in [0, 1)";
+            else if (!(pair.bowtie >= 0.0f && pair.bowtie <= 1.0f))
+                error = "stick bowtie must be in [0, 1]";
+        }
+        for (const ConfigBinding &binding : config.bindings)
+        {
+            if (!error.empty())
+                break;
+            if (binding.code < 0 || binding.command < 0 || binding.command > 63)
+                error = "binding codes must be non-negative and commands in [0, 63]";
+        }
+        return error.empty();
+    }
+}
+
+// 解析 TOML 子集并覆盖到 config 上: [section]、key = value、# 注释; 值为数字、true/false 或双引号字符串。
+// 小节: 顶层 (deadzone, trigger_deadzone, poll_interval_ms)、[filter]、[debounce]、
+// [stick.<名称>] (每节一个摇杆对, 出现后替换全部摇杆对)、[bindings] (出现后替换全部绑定)。
+// 未知的小节和键、超出范围的数值视为错误, 失败时 config 内容不确定, 调用方应在副本上解析
+inline bool parseJoystickConfig(const std::string &text, JoystickConfig &config, std::string &error)
+{
+    using namespace joystick_config_detail;
+    Interpreter interpreter(config);
+    std::istringstream in(text);
+    std::string raw;
+    int line_number = 0;
+    while (std::getline(in, raw))
+    {
+        ++line_number;
+        // 去掉字符串外的注释
+        bool quoted = false;
+        std::size_t cut = raw.size();
+        for (std::size_t i = 0; i < raw.size(); ++i)
+        {
+            if (raw[i] == '"')
+                quoted = !quoted;
+            else if (raw[i] == '#' && !quoted)
+            {
+                cut = i;
+                break;
+            }
+        }
+        std::string line = trim(raw.substr(0, cut));
+        if (line.empty())
+            continue;
+
+        std::string message;
+        if (line[0] == '[')
+        {
+            if (line[line.size() - 1] != ']')
+                message = "unterminated section header";
+            else
+                interpreter.section(trim(line.substr(1, line.size() - 2)), message);
+        }
+        else
+        {
+            std::size_t equals = line.find('=');
+            if (equals == std::string::npos)
+            {
+                message = "expected key = value";
+            }
+            else
+            {
+                std::string key = trim(line.substr(0, equals));
+                Value value;
+                value.text = trim(line.substr(equals + 1));
+                if (!value.text.empty() && value.text[0] == '"')
+                {
+                    if (value.text.size() < 2 || value.text[value.text.size() - 1] != '"')
+                        message = "unterminated string";
+                    value.is_string = true;
+                    value.text = value.text.substr(1, value.text.size() >= 2 ? value.text.size() - 2 : 0);
+                }
+                else if (value.text == "true" || value.text == "false")
+                {
+                    value.text = value.text == "true" ? "1" : "0";
+                }
+                if (message.empty())
+                    interpreter.set(key, value, message);
+            }
+        }
+        if (!message.empty())
+        {
+            error = "line " + std::to_string(line_number) + ": " + message;
+            return false;
+        }
+    }
+    return validate(config, error);
+}
+
+inline bool loadJoystickConfig(const std::string &path, JoystickConfig &config, std::string &error)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return parseJoystickConfig(text.str(), config, error);
+}
+
+// 监视配置文件 (inotify 监视所在目录, 编辑器先写临时文件再改名也能收到),
+// 文件写完后在监视线程上调用 changed; 连续的写入合并成一次
+class ConfigWatcher
+{
+public:
+    typedef std::function<void()> Changed;
+
+    ConfigWatcher(const std::string &path, Changed changed)
+        : changed_(changed)
+    {
+#ifdef __linux__
+        std::size_t slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        name_ = slash == std::string::npos ? path : path.substr(slash + 1);
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0)
+            return;
+        if (inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0 || pipe(wake_) != 0)
+        {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+        thread_ = std::thread(&ConfigWatcher::run, this);
+#else
+        (void)path;
+#endif
+    }
+
+    ~ConfigWatcher()
+    {
+#ifdef __linux__
+        stopping_ = true;
+        if (thread_.joinable())
+        {
+            char byte = 0;
+            ssize_t ignored = write(wake_[1], &byte, 1);
+            (void)ignored;
+            thread_.join();
+            close(wake_[0]);
+            close(wake_[1]);
+        }
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    bool watching() const
+    {
+        return thread_.joinable();
+    }
+
+private:
+#ifdef __linux__
+    void run()
+    {
+        pollfd polls[2];
+        polls[0].fd = fd_;
+        polls[0].events = POLLIN;
+        polls[1].fd = wake_[0];
+        polls[1].events = POLLIN;
+        alignas(inotify_event) char buffer[4096];
+        bool dirty = false;
+        while (!stopping_)
+        {
+            // 有未处理的修改时再等 100ms, 没有新事件才重新加载
+            int ready = poll(polls, 2, dirty ? 100 : -1);
+            if (stopping_)
+                break;
+            if (ready == 0 && dirty)
+            {
+                dirty = false;
+                changed_();
+                continue;
+            }
+            if (ready < 0 || !(polls[0].revents & POLLIN))
+                continue;
+            ssize_t n;
+            while ((n = read(fd_, buffer, sizeof(buffer))) > 0)
+            {
+                for (char *p = buffer; p < buffer + n;)
+                {
+                    const inotify_event *event = reinterpret_cast<const inotify_event *>(p);
+                    if (event->len > 0 && name_ == event->name)
+                        dirty = true;
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+    }
+
+    std::string name_;
+    int fd_ = -1;
+    int wake_[2] = {-1, -1};
+#endif
+    Changed changed_;
+    std::atomic_bool stopping_{false};
+    std::thread thread_;
+};
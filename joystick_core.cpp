@@ -0,0 +1,1313 @@
+#include "joystick_core.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std::chrono;
+
+namespace
+{
+    // 区分实例, 线程缓存不会把已销毁实例的快照当成新实例的
+    std::atomic<uint64_t> next_instance_id{1};
+
+    // 没有配置摇杆对时使用轴 0/1 和 2/3
+    std::vector<StickPairConfig> defaultStickPairs()
+    {
+        StickPairConfig left, right;
+        right.x_axis = 2;
+        right.y_axis = 3;
+        return std::vector<StickPairConfig>{left, right};
+    }
+}
+
+SimpleJoystick::SimpleJoystick(const JoystickOptions &options)
+    : options_(options),
+      default_axis_filter_(options.axis_filter),
+      axis_pipeline_(options.axis_pipeline),
+      stick_pairs_(options.stick_pairs),
+      haptic_backend_(options.haptic_backend ? options.haptic_backend : std::make_shared<SdlHapticBackend>()),
+      virtual_output_(options.virtual_output),
+      observer_(options.observer),
+      fusion_(options.fusion_beta),
+      instance_id_(next_instance_id.fetch_add(1, std::memory_order_relaxed))
+{
+    if (options_.orientation)
+        options_.sensors = true;
+
+    // 标准布局需要 SDL 的映射数据库
+    Uint32 subsystems = SDL_INIT_JOYSTICK;
+    if (options_.game_controller || options_.sensors)
+        subsystems |= SDL_INIT_GAMECONTROLLER;
+    if (SDL_Init(subsystems) < 0)
+    {
+        throw std::runtime_error("SDL init failed: " + std::string(SDL_GetError()));
+    }
+
+    if (!options_.mappings_file.empty())
+    {
+        std::string error;
+        if (!mapping_table_.loadFile(options_.mappings_file, error))
+        {
+            SDL_Quit();
+            throw std::runtime_error("Controller mappings: " + error);
+        }
+        std::cout << "Loaded " << mapping_table_.size() << " controller mappings" << std::endl;
+    }
+
+    // 命令行的间隔按配置文件的取值范围截断, 否则带 --config 时会在校验里失败
+    base_config_.poll_interval_ms = std::min(std::max(options_.poll_interval_ms, 1), 1000);
+    base_config_.axis_filter = options_.axis_filter;
+    base_config_.stick_pairs = options_.stick_pairs;
+    if (!options_.config_file.empty())
+    {
+        std::shared_ptr<JoystickConfig> config = std::make_shared<JoystickConfig>(base_config_);
+        std::string error;
+        if (!loadJoystickConfig(options_.config_file, *config, error))
+        {
+            SDL_Quit();
+            throw std::runtime_error("Config: " + error);
+        }
+        applyConfig(config);
+        // 事件线程启动前直接采用, 设备接入时就按文件中的参数处理
+        adoptConfig(*config, nullptr);
+        active_config_ = config.get();
+        config_ack_.store(active_config_, std::memory_order_release);
+        std::cout << "Loaded config " << options_.config_file << std::endl;
+    }
+
+    tracer_.setEnabled(options_.trace);
+    if (!options_.axis_history_windows_ms.empty())
+        axis_history_.reset(new AxisHistory(options_.axis_history_windows_ms));
+
+    // 打开所有已插入的摇杆, 第一个作为当前设备, 其余作为备用
+    hotplug_.probe();
+    if (SDL_Joystick *joystick = hotplug_.failover(""))
+    {
+        attachJoystick(joystick, ConnectionState::CONNECTED);
+    }
+
+    // 键盘/鼠标在自己的线程上读取, 有事件时唤醒事件线程
+    if (options_.keyboard_mouse)
+    {
+        evdev_.reset(new EvdevInput(
+            options_.evdev_devices, [this]
+            { wakeEventThread(); },
+            &tracer_));
+        std::cout << "Keyboard/mouse devices: " << evdev_->deviceCount() << std::endl;
+    }
+
+    // 配置文件在监视线程上重新解析, 事件线程只切换指针
+    if (!options_.config_file.empty())
+    {
+        config_watcher_.reset(new ConfigWatcher(options_.config_file, [this]
+                                                { reloadConfig(); }));
+        if (!config_watcher_->watching())
+            std::cerr << "Config file will not be reloaded: cannot watch " << options_.config_file << std::endl;
+    }
+
+    // 观察者先拿到设备接入时的初始状态, 不用等第一批事件
+    if (observer_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(data_mutex_);
+            TraceScope capture(&tracer_, "observer_capture", frame_id_);
+            observer_->capture(current_data_);
+        }
+        TraceScope published(&tracer_, "observer_published", frame_id_);
+        observer_->published();
+    }
+
+    // 启动事件线程
+    state_ = AcquisitionState::RUNNING;
+    event_thread_ = std::thread(&SimpleJoystick::eventLoop, this);
+}
+
+SimpleJoystick::~SimpleJoystick()
+{
+    config_watcher_.reset();
+    stop();
+    if (event_thread_.joinable())
+    {
+        event_thread_.join();
+    }
+    evdev_.reset();
+    closeSensors();
+    joystick_ = nullptr;
+    hotplug_.closeAll();
+    SDL_Quit();
+}
+
+JoystickData SimpleJoystick::getData()
+{
+    stats_.snapshot_reads.inc();
+    JoystickData data;
+    {
+        // 读者路径不读时钟; 锁持有时间只在事件线程上采样
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        data = current_data_;
+    }
+    return data;
+}
+
+const JoystickData &SimpleJoystick::getCachedData()
+{
+    struct Cache
+    {
+        uint64_t instance = 0;
+        uint64_t generation = 0;
+        JoystickData data;
+    };
+    static thread_local Cache cache;
+
+    uint64_t generation = data_generation_.load(std::memory_order_acquire);
+    if (cache.instance == instance_id_ && cache.generation == generation)
+        return cache.data;
+
+    stats_.snapshot_reads.inc();
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    // 拷贝赋值复用缓存里数组的容量; 锁内读到的代数与拷贝的数据一致
+    cache.data = current_data_;
+    cache.generation = data_generation_.load(std::memory_order_relaxed);
+    cache.instance = instance_id_;
+    return cache.data;
+}
+
+JoystickData SimpleJoystick::getPredictedData(milliseconds lead)
+{
+    stats_.snapshot_reads.inc();
+    uint32_t at_ms = SDL_GetTicks() + static_cast<uint32_t>(lead.count());
+    JoystickData data;
+    {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        data = current_data_;
+        // 自定义流水线的阶段不一定能按速度外推, 直接返回当前值
+        if (axis_pipeline_)
+            return data;
+        std::vector<float> predicted(stick_values_);
+        for (std::size_t i = 0; i < axis_filters_.size() && i < data.axes.size(); ++i)
+        {
+            if (!axis_filters_[i].active())
+                continue;
+            predicted[i] = axis_filters_[i].predict(at_ms, axisFilterConfig(i));
+            if (!stick_deadzones_.contains(i))
+                data.axes[i] = applyDeadzone(predicted[i]);
+        }
+        stick_deadzones_.apply(predicted.data(), data.axes.data());
+    }
+    return data;
+}
+
+void SimpleJoystick::setStickPairs(const std::vector<StickPairConfig> &pairs)
+{
+    DataWriteLock lock(*this);
+    stick_pairs_ = pairs;
+    configureStickPairs();
+    stick_deadzones_.apply(stick_values_.data(), current_data_.axes.data());
+}
+
+void SimpleJoystick::setAxisFilter(const AxisFilterConfig &config)
+{
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    default_axis_filter_ = config;
+    axis_filter_config_.clear();
+}
+
+void SimpleJoystick::setAxisFilter(std::size_t axis, const AxisFilterConfig &config)
+{
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    if (axis_filter_config_.size() <= axis)
+        axis_filter_config_.resize(axis + 1, default_axis_filter_);
+    axis_filter_config_[axis] = config;
+}
+
+bool SimpleJoystick::resume()
+{
+    return transition(AcquisitionState::PAUSED, AcquisitionState::RUNNING) ||
+           transition(AcquisitionState::DRAINING, AcquisitionState::RUNNING);
+}
+
+void SimpleJoystick::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        state_ = AcquisitionState::STOPPED;
+        stats_.acquisition_state.set(static_cast<int64_t>(AcquisitionState::STOPPED));
+    }
+    state_cv_.notify_all();
+    frame_signal_.wakeAll();
+}
+
+AcquisitionState SimpleJoystick::waitWhilePaused(milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    state_cv_.wait_for(lock, timeout, [this]
+                       { return state_ == AcquisitionState::RUNNING || state_ == AcquisitionState::STOPPED; });
+    return state_;
+}
+
+void SimpleJoystick::setButtonDebounce(DebounceMode mode, uint32_t window_ms)
+{
+    debouncer_.setWindow(window_ms);
+    debouncer_.setMode(mode);
+}
+
+bool SimpleJoystick::takeBallDelta(std::size_t ball, int &dx, int &dy)
+{
+    if (ball >= MAX_BALLS)
+        return false;
+    unpackDelta(ball_delta_[ball].exchange(0, std::memory_order_acq_rel), dx, dy);
+    return true;
+}
+
+void SimpleJoystick::takeMouseDelta(int &dx, int &dy, int &wheel)
+{
+    unpackDelta(mouse_delta_.exchange(0, std::memory_order_acq_rel), dx, dy);
+    wheel = mouse_wheel_.exchange(0, std::memory_order_acq_rel);
+}
+
+void SimpleJoystick::setLed(uint8_t red, uint8_t green, uint8_t blue)
+{
+    led_set_ = true;
+    postHaptic(HapticMailbox::LED, HapticMailbox::packLed(red, green, blue));
+}
+
+void SimpleJoystick::attachJoystick(SDL_Joystick *joystick, ConnectionState state)
+{
+    closeSensors();
+    joystick_ = joystick;
+    joystick_id_ = SDL_JoystickInstanceID(joystick);
+
+    int num_axes = SDL_JoystickNumAxes(joystick_);
+    int num_buttons = SDL_JoystickNumButtons(joystick_);
+    int num_hats = std::min(SDL_JoystickNumHats(joystick_), static_cast<int>(MAX_HATS));
+
+    // 同一 GUID 只在第一次连接时校准和查映射, 重连沿用之前的结果
+    DeviceProfile &profile = hotplug_.profileFor(joystick_);
+    if (!profile.calibrated)
+    {
+        calibrateRest(profile, num_axes);
+    }
+    if (!profile.mapping_resolved)
+    {
+        resolveMapping(profile);
+    }
+    active_guid_ = profile.guid;
+    axis_rest_ = profile.axis_rest;
+    buildRoutes(profile, num_axes, num_buttons);
+    for (auto &delta : ball_delta_)
+        delta.store(0, std::memory_order_relaxed);
+
+    // 用新设备的当前状态覆盖旧数据, 切换后不残留上一个设备的值
+    uint64_t button_mask = 0;
+    {
+        DataWriteLock lock(*this);
+        bool standard = profile.mapping != nullptr;
+        current_data_.standard_layout = standard;
+        current_data_.axes.assign(standard ? STANDARD_AXIS_COUNT : num_axes, 0.0f);
+        current_data_.buttons.assign(num_buttons_, false);
+        current_data_.triggers.fill(0.0f);
+        current_data_.num_triggers = 0;
+        current_data_.orientation = {{1.0f, 0.0f, 0.0f, 0.0f}};
+        current_data_.has_orientation = false;
+        axis_filters_.assign(current_data_.axes.size(), AxisFilter());
+        if (axis_history_)
+            axis_history_->reset(current_data_.axes.size());
+        stick_values_.assign(current_data_.axes.size(), 0.0f);
+        // 扳机轴不参与摇杆对
+        stick_axes_.assign(current_data_.axes.size(), false);
+        for (const AxisRoute &route : axis_route_)
+        {
+            if (route.axis >= 0 && route.trigger < 0 && !route.as_trigger &&
+                static_cast<std::size_t>(route.axis) < stick_axes_.size())
+                stick_axes_[route.axis] = true;
+        }
+        configureStickPairs();
+        uint32_t now_ms = SDL_GetTicks();
+        for (int i = 0; i < num_axes; ++i)
+        {
+            applyAxis(i, SDL_JoystickGetAxis(joystick_, i), now_ms);
+        }
+        stick_deadzones_.apply(stick_values_.data(), current_data_.axes.data());
+        sticks_dirty_ = false;
+        current_data_.hats.fill(SDL_HAT_CENTERED);
+        current_data_.num_hats = static_cast<uint8_t>(num_hats);
+        for (int i = 0; i < num_hats; ++i)
+        {
+            current_data_.hats[i] = SDL_JoystickGetHat(joystick_, i);
+            if (static_cast<std::size_t>(i) >= hat_route_.size())
+                continue;
+            for (int bit = 0; bit < 4; ++bit)
+            {
+                int target = hat_route_[i][bit];
+                if (target >= 0 && (current_data_.hats[i] & (1u << bit)))
+                    current_data_.buttons[target] = true;
+            }
+        }
+        for (int i = 0; i < num_buttons; ++i)
+        {
+            bool pressed = SDL_JoystickGetButton(joystick_, i) == SDL_PRESSED;
+            if (static_cast<std::size_t>(i) < button_axis_route_.size() && button_axis_route_[i] >= 0)
+            {
+                applyDigitalAxis(button_axis_route_[i], pressed, now_ms);
+                continue;
+            }
+            int target = button_route_[i];
+            if (target >= 0 && pressed)
+                current_data_.buttons[target] = true;
+        }
+        for (std::size_t i = 0; i < current_data_.buttons.size() && i < ButtonDebouncer::MAX_BUTTONS; ++i)
+        {
+            if (current_data_.buttons[i])
+                button_mask |= uint64_t(1) << i;
+        }
+    }
+    debouncer_.reset(button_mask);
+    published_buttons_ = button_mask;
+    fusion_.reset();
+    fusion_dirty_ = false;
+    if (led_set_)
+        haptics_.repost(HapticMailbox::LED);
+    if (options_.sensors)
+        openSensors();
+    stats_.connects.inc();
+    stats_.connected.set(1);
+    publishConnection(state);
+
+    std::cout << "Joystick connected: " << SDL_JoystickName(joystick_) << std::endl
+              << "ID: " << joystick_id_ << std::endl
+              << "Axes: " << num_axes
+              << ", Buttons: " << num_buttons
+              << ", Hats: " << num_hats
+              << ", Triggers: " << profile.trigger_axes.size() << std::endl;
+    if (profile.mapping)
+    {
+        std::cout << "Standard layout: " << profile.mapping->name << std::endl;
+    }
+}
+
+void SimpleJoystick::resolveMapping(DeviceProfile &profile)
+{
+    profile.mapping_resolved = true;
+    if (!mappingEnabled())
+        return;
+
+    SDL_JoystickGUID guid = SDL_JoystickGetGUID(joystick_);
+    profile.mapping = mapping_table_.find(guid);
+    if (!profile.mapping && options_.game_controller)
+    {
+        char *text = SDL_GameControllerMappingForGUID(guid);
+        if (text)
+        {
+            SDL_JoystickGUID parsed;
+            ControllerMapping mapping;
+            if (parseControllerMapping(text, parsed, mapping))
+                profile.mapping = std::make_shared<const ControllerMapping>(mapping);
+            SDL_free(text);
+        }
+    }
+}
+
+void SimpleJoystick::buildRoutes(const DeviceProfile &profile, int num_axes, int num_buttons)
+{
+    axis_route_.assign(num_axes, AxisRoute());
+    button_route_.assign(num_buttons, -1);
+    button_axis_route_.clear();
+    hat_route_.clear();
+
+    const ControllerMapping *mapping = profile.mapping.get();
+    if (!mapping)
+    {
+        for (int i = 0; i < num_axes; ++i)
+            axis_route_[i].axis = static_cast<int8_t>(i);
+        for (std::size_t t = 0; t < profile.trigger_axes.size() && t < MAX_TRIGGERS; ++t)
+        {
+            if (profile.trigger_axes[t] < num_axes)
+                axis_route_[profile.trigger_axes[t]].trigger = static_cast<int8_t>(t);
+        }
+        for (int i = 0; i < num_buttons; ++i)
+            button_route_[i] = static_cast<int16_t>(i);
+        num_buttons_ = num_buttons;
+        return;
+    }
+
+    for (int i = 0; i < num_axes && static_cast<std::size_t>(i) < mapping->axis_to_axis.size(); ++i)
+    {
+        const ControllerMapping::AxisSource &source = mapping->axis_to_axis[i];
+        AxisRoute &route = axis_route_[i];
+        route.axis = source.target;
+        route.invert = source.invert;
+        if (source.target == SDL_CONTROLLER_AXIS_TRIGGERLEFT || source.target == SDL_CONTROLLER_AXIS_TRIGGERRIGHT)
+        {
+            route.as_trigger = true;
+            route.trigger = static_cast<int8_t>(source.target - SDL_CONTROLLER_AXIS_TRIGGERLEFT);
+        }
+    }
+    for (int i = 0; i < num_buttons && static_cast<std::size_t>(i) < mapping->button_to_button.size(); ++i)
+        button_route_[i] = mapping->button_to_button[i];
+    button_axis_route_ = mapping->button_to_axis;
+    hat_route_ = mapping->hat_to_button;
+    num_buttons_ = static_cast<int>(STANDARD_BUTTON_COUNT);
+}
+
+void SimpleJoystick::applyAxis(std::size_t raw_axis, Sint16 raw_value, uint32_t timestamp_ms)
+{
+    const AxisRoute &route = axis_route_[raw_axis];
+    if (route.axis < 0 || static_cast<std::size_t>(route.axis) >= current_data_.axes.size())
+        return;
+
+    Sint16 raw = route.invert ? static_cast<Sint16>(-1 - raw_value) : raw_value;
+    float trigger = route.trigger >= 0 ? normalizeTrigger(raw) : 0.0f;
+    if (route.as_trigger)
+    {
+        current_data_.axes[route.axis] = trigger;
+    }
+    else if (route.trigger >= 0)
+    {
+        current_data_.axes[route.axis] = applyDeadzone(normalizeAxis(raw_axis, raw));
+    }
+    else if (axis_pipeline_)
+    {
+        float value = (*axis_pipeline_)(raw, axisContext(raw_axis, route.axis, timestamp_ms));
+        stick_values_[route.axis] = value;
+        current_data_.axes[route.axis] = value;
+    }
+    else
+    {
+        float value = stick_pipeline_(raw, axisContext(raw_axis, route.axis, timestamp_ms));
+        stick_values_[route.axis] = value;
+        // 摇杆对的两个轴要一起算死区, 留到本帧发布时处理
+        if (stick_deadzones_.contains(route.axis))
+            sticks_dirty_ = true;
+        else
+            current_data_.axes[route.axis] = applyDeadzone(value);
+    }
+    if (route.trigger >= 0)
+    {
+        current_data_.triggers[route.trigger] = trigger;
+        current_data_.num_triggers = std::max<uint8_t>(current_data_.num_triggers, route.trigger + 1);
+    }
+    // 每个事件都记录, 一批事件中间的峰值也在统计里
+    if (axis_history_)
+    {
+        bool stick = route.trigger < 0 && !route.as_trigger;
+        axis_history_->record(route.axis, timestamp_ms,
+                              stick ? stick_values_[route.axis] : current_data_.axes[route.axis]);
+    }
+}
+
+void SimpleJoystick::configureStickPairs()
+{
+    static const std::vector<StickPairConfig> no_pairs;
+    static const std::vector<StickPairConfig> default_pairs = defaultStickPairs();
+    // 死区由自定义流水线处理时不配置摇杆对; 直接引用, 不复制参数数组
+    const std::vector<StickPairConfig> &pairs =
+        axis_pipeline_ ? no_pairs : (stick_pairs_.empty() ? default_pairs : stick_pairs_);
+    stick_deadzones_.configure(pairs, stick_axes_);
+}
+
+void SimpleJoystick::applyDigitalAxis(int axis, bool pressed, uint32_t timestamp_ms)
+{
+    float value = pressed ? 1.0f : 0.0f;
+    if (static_cast<std::size_t>(axis) < current_data_.axes.size())
+    {
+        current_data_.axes[axis] = value;
+        if (axis_history_)
+            axis_history_->record(axis, timestamp_ms, value);
+    }
+    if (axis == SDL_CONTROLLER_AXIS_TRIGGERLEFT || axis == SDL_CONTROLLER_AXIS_TRIGGERRIGHT)
+    {
+        int slot = axis - SDL_CONTROLLER_AXIS_TRIGGERLEFT;
+        current_data_.triggers[slot] = value;
+        current_data_.num_triggers = std::max<uint8_t>(current_data_.num_triggers, slot + 1);
+    }
+}
+
+void SimpleJoystick::openSensors()
+{
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+    for (int i = 0; i < SDL_NumJoysticks(); ++i)
+    {
+        if (SDL_JoystickGetDeviceInstanceID(i) != joystick_id_)
+            continue;
+        if (!SDL_IsGameController(i) || !(sensor_controller_ = SDL_GameControllerOpen(i)))
+            return;
+        break;
+    }
+    if (!sensor_controller_)
+        return;
+
+    const SDL_SensorType types[] = {SDL_SENSOR_ACCEL, SDL_SENSOR_GYRO};
+    uint8_t enabled = 0;
+    for (int t = 0; t < 2; ++t)
+    {
+        if (SDL_GameControllerHasSensor(sensor_controller_, types[t]) &&
+            SDL_GameControllerSetSensorEnabled(sensor_controller_, types[t], SDL_TRUE) == 0)
+        {
+            enabled |= static_cast<uint8_t>(1u << t);
+            std::cout << (t == 0 ? "Accelerometer" : "Gyroscope") << ": "
+                      << SDL_GameControllerGetSensorDataRate(sensor_controller_, types[t]) << " Hz" << std::endl;
+        }
+    }
+    imu_sensors_ = enabled;
+    if (!enabled)
+        closeSensors();
+#endif
+}
+
+void SimpleJoystick::closeSensors()
+{
+    imu_sensors_ = 0;
+    if (sensor_controller_)
+    {
+        SDL_GameControllerClose(sensor_controller_);
+        sensor_controller_ = nullptr;
+    }
+}
+
+void SimpleJoystick::detachJoystick()
+{
+    closeSensors();
+    joystick_ = nullptr;
+    joystick_id_ = -1;
+    stats_.disconnects.inc();
+    stats_.connected.set(0);
+    publishConnection(ConnectionState::DISCONNECTED);
+}
+
+void SimpleJoystick::calibrateRest(DeviceProfile &profile, int num_axes)
+{
+    // 偏离中心超过 1/4 量程的轴不做中心校准, 静止在负端点的轴视为扳机
+    constexpr int MAX_REST_OFFSET = 8192;
+
+    profile.axis_rest.assign(num_axes, 0);
+    profile.trigger_axes.clear();
+    for (int i = 0; i < num_axes; ++i)
+    {
+        Sint16 rest = 0;
+        if (!SDL_JoystickGetAxisInitialState(joystick_, i, &rest))
+            rest = SDL_JoystickGetAxis(joystick_, i);
+        if (std::abs(rest) < MAX_REST_OFFSET)
+            profile.axis_rest[i] = rest;
+        else if (rest <= -32768 + MAX_REST_OFFSET)
+            profile.trigger_axes.push_back(i);
+    }
+    profile.calibrated = true;
+}
+
+void SimpleJoystick::failoverJoystick()
+{
+    std::cout << "Joystick disconnected" << std::endl;
+    SDL_Joystick *next = hotplug_.failover(active_guid_);
+    if (next)
+    {
+        stats_.disconnects.inc();
+        stats_.failovers.inc();
+        attachJoystick(next, ConnectionState::FAILOVER);
+    }
+    else
+    {
+        detachJoystick();
+    }
+}
+
+void SimpleJoystick::probeDevices()
+{
+    hotplug_.probe();
+    if (joystick_ && !hotplug_.active())
+    {
+        failoverJoystick();
+    }
+    else if (!joystick_)
+    {
+        if (SDL_Joystick *joystick = hotplug_.failover(active_guid_))
+            attachJoystick(joystick, ConnectionState::CONNECTED);
+    }
+}
+
+void SimpleJoystick::reconnect()
+{
+    stats_.reconnect_requests.inc();
+    if (joystick_)
+    {
+        detachJoystick();
+    }
+    hotplug_.closeAll();
+    probeDevices();
+}
+
+bool SimpleJoystick::transition(AcquisitionState from, AcquisitionState to)
+{
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (state_ != from)
+            return false;
+        state_ = to;
+        stats_.acquisition_state.set(static_cast<int64_t>(to));
+    }
+    state_cv_.notify_all();
+    frame_signal_.wakeAll();
+    return true;
+}
+
+void SimpleJoystick::publishConnection(ConnectionState state)
+{
+    connection_state_ = state;
+
+    ConnectionEvent event;
+    event.state = state;
+    event.instance_id = joystick_id_;
+    std::snprintf(event.guid, sizeof(event.guid), "%s", active_guid_.c_str());
+    if (observer_)
+        observer_->connection(event);
+    // 消费者不读时丢弃新事件, 不能阻塞事件线程
+    if (!connection_events_.push(event))
+        stats_.connection_events_dropped.inc();
+}
+
+void SimpleJoystick::postHaptic(HapticMailbox::Channel channel, uint64_t value)
+{
+    stats_.haptic_requests.inc();
+    if (haptics_.post(channel, value))
+    {
+        stats_.haptic_merged.inc();
+        return;
+    }
+    wakeEventThread();
+}
+
+void SimpleJoystick::wakeEventThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+    }
+    state_cv_.notify_all();
+}
+
+void SimpleJoystick::applyHaptics()
+{
+    // 没有设备时照常交给后端 (joystick 为空), 由后端决定是否失败
+    uint32_t dirty = haptics_.take();
+    if (!dirty)
+        return;
+
+    for (uint32_t bits = dirty; bits; bits &= bits - 1)
+    {
+        HapticMailbox::Channel channel = static_cast<HapticMailbox::Channel>(__builtin_ctz(bits));
+        uint64_t value = haptics_.value(channel);
+        uint16_t a = static_cast<uint16_t>(value);
+        uint16_t b = static_cast<uint16_t>(value >> 16);
+        uint32_t duration_ms = static_cast<uint32_t>(value >> 32);
+        bool ok = false;
+        switch (channel)
+        {
+        case HapticMailbox::RUMBLE:
+            ok = haptic_backend_->rumble(joystick_, a, b, duration_ms);
+            break;
+        case HapticMailbox::RUMBLE_TRIGGERS:
+            ok = haptic_backend_->rumbleTriggers(joystick_, a, b, duration_ms);
+            break;
+        case HapticMailbox::LED:
+            ok = haptic_backend_->setLed(joystick_, static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+                                         static_cast<uint8_t>(value >> 16));
+            break;
+        default:
+            break;
+        }
+        (ok ? stats_.haptic_applied : stats_.haptic_failed).inc();
+    }
+}
+
+void SimpleJoystick::writeVirtualOutput(uint64_t frame)
+{
+    TraceScope scope(&tracer_, "virtual_output", frame);
+    std::size_t count = virtual_pad_.staged() + 1;
+    scope.setArg(count);
+    if (virtual_pad_.flush(*virtual_output_))
+    {
+        stats_.virtual_frames.inc();
+        stats_.virtual_events.inc(count);
+    }
+    else
+    {
+        stats_.virtual_errors.inc();
+    }
+}
+
+uint64_t SimpleJoystick::drainEvents(uint64_t frame)
+{
+    SDL_Event event;
+    uint64_t batch = 0;
+    uint32_t oldest_ms = 0;
+    TraceScope drain(&tracer_, "drain", frame);
+    while (SDL_PollEvent(&event))
+    {
+        if (batch++ == 0)
+            oldest_ms = event.common.timestamp;
+        switch (event.type)
+        {
+        case SDL_JOYAXISMOTION:
+            handleAxisEvent(event.jaxis);
+            break;
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            handleButtonEvent(event.jbutton);
+            break;
+        case SDL_JOYHATMOTION:
+            handleHatEvent(event.jhat);
+            break;
+        case SDL_JOYBALLMOTION:
+            handleBallEvent(event.jball);
+            break;
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+        case SDL_CONTROLLERSENSORUPDATE:
+            handleSensorEvent(event.csensor);
+            break;
+#endif
+        case SDL_JOYDEVICEADDED:
+            // 新设备立即打开放入备用列表
+            hotplug_.onDeviceAdded(event.jdevice.which);
+            if (!joystick_)
+            {
+                if (SDL_Joystick *joystick = hotplug_.failover(active_guid_))
+                    attachJoystick(joystick, ConnectionState::CONNECTED);
+            }
+            break;
+        case SDL_JOYDEVICEREMOVED:
+            if (hotplug_.onDeviceRemoved(event.jdevice.which))
+            {
+                failoverJoystick();
+            }
+            break;
+        }
+    }
+
+    // 只有 SDL 事件带 SDL 时间戳, 排队时长只按它们算
+    uint64_t sdl_batch = batch;
+    if (evdev_)
+    {
+        TraceScope evdev(&tracer_, "evdev_drain", frame);
+        uint64_t evdev_batch = drainEvdev();
+        if (evdev_batch == 0)
+            evdev.cancel();
+        evdev.setArg(evdev_batch);
+        batch += evdev_batch;
+    }
+
+    if (batch == 0)
+    {
+        drain.cancel();
+        return 0;
+    }
+    drain.setArg(batch);
+    // 最早的事件进入 SDL 队列 (毫秒时间戳) 到本轮取完, 换算到追踪时钟上
+    if (tracer_.enabled() && sdl_batch > 0)
+    {
+        uint64_t now_ns = FrameTracer::now();
+        uint64_t waited_ns = static_cast<uint64_t>(SDL_GetTicks() - oldest_ms) * 1000000u;
+        tracer_.record("sdl_queue", frame, now_ns > waited_ns ? now_ns - waited_ns : 0, now_ns, sdl_batch);
+    }
+    return batch;
+}
+
+void SimpleJoystick::eventLoop()
+{
+    // 约每秒重新扫描一次设备, 清理失效句柄; 启动时已采用的配置文件优先于命令行参数
+    int poll_interval_ms = active_config_ ? active_config_->poll_interval_ms : base_config_.poll_interval_ms;
+    uint32_t probe_every_n_cycles = std::max(1, 1000 / poll_interval_ms);
+    milliseconds poll_interval(poll_interval_ms);
+
+    tracer_.nameThread("event");
+    if (options_.realtime.enabled())
+    {
+        // 没有权限时各项单独失败, 线程照常以普通调度运行
+        RealtimeStatus status = applyRealtime(options_.realtime);
+        std::cout << "Realtime: affinity " << (status.affinity ? "on" : "off") << ", SCHED_FIFO "
+                  << (status.fifo ? "on" : "off") << ", mlockall " << (status.memory_locked ? "on" : "off")
+                  << (status.errors.empty() ? "" : " (" + status.errors + ")") << std::endl;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        realtime_status_ = status;
+    }
+    while (true)
+    {
+        AcquisitionState state = state_;
+        if (state == AcquisitionState::STOPPED)
+            break;
+
+        // 新的运行参数在帧之间采用, 平时只有一次原子读
+        const JoystickConfig *config = config_.load(std::memory_order_acquire);
+        if (config != active_config_)
+        {
+            adoptConfig(*config, active_config_);
+            active_config_ = config;
+            config_ack_.store(config, std::memory_order_release);
+            poll_interval = milliseconds(config->poll_interval_ms);
+            probe_every_n_cycles = std::max(1, 1000 / config->poll_interval_ms);
+        }
+
+        if (state == AcquisitionState::PAUSED)
+        {
+            // 暂停时不轮询 SDL, 线程不占 CPU; 输出请求照常下发
+            {
+                std::unique_lock<std::mutex> lock(state_mutex_);
+                state_cv_.wait(lock, [this]
+                               { return state_ != AcquisitionState::PAUSED || haptics_.pending(); });
+            }
+            applyHaptics();
+            continue;
+        }
+
+        uint64_t frame = frame_id_ + 1;
+        uint64_t batch = drainEvents(frame);
+        stats_.drain_batch.observe(batch);
+        // 没有新事件时去抖计时到期也会改变按钮, 同样作为一帧发布
+        bool publish_frame = false;
+        {
+            TraceScope publish(&tracer_, "publish", frame);
+            publish_frame = publishDebouncedButtons(SDL_GetTicks()) || batch > 0;
+            if (!publish_frame)
+            {
+                // 空转的轮次不记录
+                publish.cancel();
+            }
+            else
+            {
+                frame_id_ = frame;
+                DataWriteLock lock(*this);
+                current_data_.frame_id = frame;
+                if (sticks_dirty_)
+                {
+                    stick_deadzones_.apply(stick_values_.data(), current_data_.axes.data());
+                    sticks_dirty_ = false;
+                }
+                // 一批样本融合完只发布最终姿态
+                if (fusion_dirty_)
+                {
+                    current_data_.orientation = fusion_.quaternion();
+                    current_data_.has_orientation = true;
+                    fusion_dirty_ = false;
+                }
+                // 锁内只比较和编码, 写设备放到锁外
+                if (virtual_output_)
+                    virtual_pad_.stage(current_data_);
+                if (observer_)
+                {
+                    TraceScope capture(&tracer_, "observer_capture", frame);
+                    observer_->capture(current_data_);
+                }
+            }
+        }
+        // 没有新事件的轮次也发布, 窗口随时间滑动
+        if (axis_history_)
+            axis_history_->publish(SDL_GetTicks());
+        if (virtual_output_ && virtual_pad_.staged())
+            writeVirtualOutput(frame);
+        if (publish_frame)
+        {
+            if (observer_)
+            {
+                TraceScope published(&tracer_, "observer_published", frame);
+                observer_->published();
+            }
+            frame_signal_.publish(frame);
+        }
+        applyHaptics();
+
+        if (reconnect_requested_.exchange(false))
+        {
+            reconnect();
+        }
+        else if (++probe_tick_ % probe_every_n_cycles == 0)
+        {
+            probeDevices();
+        }
+
+        // 暂停请求发出前排队的事件已全部处理
+        if (state == AcquisitionState::DRAINING)
+        {
+            transition(AcquisitionState::DRAINING, AcquisitionState::PAUSED);
+            continue;
+        }
+
+        // 可被状态切换打断的轮询间隔, 有按钮在去抖计时时提前醒来
+        milliseconds wait(poll_interval);
+        if (debouncer_.hasPending())
+        {
+            int32_t until = static_cast<int32_t>(debouncer_.nextDeadline() - SDL_GetTicks());
+            wait = std::min(wait, milliseconds(std::max<int32_t>(until, 1)));
+        }
+        // 超时醒来的时刻与预定时刻之差即调度抖动
+        steady_clock::time_point deadline = steady_clock::now() + wait;
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        bool woken = state_cv_.wait_until(lock, deadline, [this, state]
+                                          { return state_ != state || haptics_.pending() || (evdev_ && evdev_->pending()) ||
+                                                   config_.load(std::memory_order_relaxed) != active_config_; });
+        if (!woken)
+            stats_.wakeup_lateness_ns.observe(
+                static_cast<uint64_t>(std::max<int64_t>(0, duration_cast<nanoseconds>(steady_clock::now() - deadline).count())));
+    }
+}
+
+RealtimeStatus SimpleJoystick::realtimeStatus()
+{
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    return realtime_status_;
+}
+
+void SimpleJoystick::applyConfig(std::shared_ptr<const JoystickConfig> config)
+{
+    if (!config)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        // 事件线程回报过的版本之前的都不会再被读到, 可以释放
+        const JoystickConfig *acked = config_ack_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < config_history_.size(); ++i)
+        {
+            if (config_history_[i].get() == acked)
+            {
+                config_history_.erase(config_history_.begin(), config_history_.begin() + i);
+                break;
+            }
+        }
+        config_history_.push_back(config);
+        config_.store(config.get(), std::memory_order_release);
+        config_generation_.fetch_add(1, std::memory_order_release);
+    }
+    wakeEventThread();
+}
+
+std::shared_ptr<const JoystickConfig> SimpleJoystick::config()
+{
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_history_.empty() ? nullptr : config_history_.back();
+}
+
+void SimpleJoystick::reloadConfig()
+{
+    std::shared_ptr<JoystickConfig> config = std::make_shared<JoystickConfig>(base_config_);
+    std::string error;
+    if (!loadJoystickConfig(options_.config_file, *config, error))
+    {
+        stats_.config_errors.inc();
+        std::cerr << "Config reload failed, keeping current settings: " << error << std::endl;
+        return;
+    }
+    stats_.config_reloads.inc();
+    applyConfig(config);
+    std::cout << "Config reloaded from " << options_.config_file << std::endl;
+}
+
+void SimpleJoystick::adoptConfig(const JoystickConfig &config, const JoystickConfig *previous)
+{
+    using namespace joystick_config_detail;
+
+    // 文件没有改动的项不覆盖运行时用 setXxx() 做的修改
+    if (!previous || config.debounce_mode != previous->debounce_mode)
+        debouncer_.setMode(config.debounce_mode);
+    if (!previous || config.debounce_ms != previous->debounce_ms)
+        debouncer_.setWindow(config.debounce_ms);
+    bool deadzones = !previous || config.deadzone != previous->deadzone ||
+                     config.trigger_deadzone != previous->trigger_deadzone;
+    bool filter = !previous || !sameFilter(config.axis_filter, previous->axis_filter);
+    bool sticks = !previous || !sameStickPairs(config.stick_pairs, previous->stick_pairs);
+    if (!deadzones && !filter && !sticks)
+        return;
+
+    // 摇杆对的数组按原容量复用, 数量不增加时不分配内存
+    DataWriteLock lock(*this);
+    if (deadzones)
+    {
+        axis_deadzone_ = config.deadzone;
+        trigger_deadzone_ = config.trigger_deadzone;
+    }
+    if (filter)
+    {
+        default_axis_filter_ = config.axis_filter;
+        axis_filter_config_.clear();
+    }
+    if (sticks)
+    {
+        stick_pairs_ = config.stick_pairs;
+        configureStickPairs();
+        stick_deadzones_.apply(stick_values_.data(), current_data_.axes.data());
+    }
+}
+
+void SimpleJoystick::handleAxisEvent(const SDL_JoyAxisEvent &event)
+{
+    // 备用设备的事件不进入数据
+    if (!joystick_ || event.which != joystick_id_)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+    stats_.axis_events.inc();
+
+    // 路由表在设备接入时生成, 这里只是一次下标访问
+    if (event.axis >= axis_route_.size() || axis_route_[event.axis].axis < 0)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+
+    DataWriteLock lock(*this);
+    ScopedLatency hold(stats_.lock_hold_ns, sampleLockTiming());
+    applyAxis(event.axis, event.value, event.timestamp);
+}
+
+float SimpleJoystick::normalizeAxis(std::size_t axis, Sint16 raw_value) const
+{
+    // 减去校准的静止位置, 标准化轴值到 [-1.0, 1.0]
+    AxisContext ctx;
+    if (axis < axis_rest_.size())
+        ctx.rest = axis_rest_[axis];
+    return CalibrateStage()(raw_value, ctx);
+}
+
+AxisContext SimpleJoystick::axisContext(std::size_t raw_axis, std::size_t axis, uint32_t timestamp_ms)
+{
+    AxisContext ctx;
+    if (raw_axis < axis_rest_.size())
+        ctx.rest = axis_rest_[raw_axis];
+    ctx.timestamp_ms = timestamp_ms;
+    ctx.filter = &axis_filters_[axis];
+    ctx.filter_config = &axisFilterConfig(axis);
+    return ctx;
+}
+
+float SimpleJoystick::applyDeadzone(float value) const
+{
+    return DeadzoneStage(axis_deadzone_)(value, AxisContext());
+}
+
+float SimpleJoystick::normalizeTrigger(Sint16 raw_value) const
+{
+    float value = (static_cast<float>(raw_value) + 32768.0f) / 65535.0f;
+    if (value > 1.0f)
+        value = 1.0f;
+    if (value < trigger_deadzone_)
+        value = 0.0f;
+    return value;
+}
+
+void SimpleJoystick::handleHatEvent(const SDL_JoyHatEvent &event)
+{
+    if (!joystick_ || event.which != joystick_id_)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+    stats_.hat_events.inc();
+
+    // 标准布局下方向键同时映射为 dpup/dpright/dpdown/dpleft 按钮, 与其他按钮一起去抖
+    if (event.hat < hat_route_.size())
+    {
+        for (int bit = 0; bit < 4; ++bit)
+        {
+            int target = hat_route_[event.hat][bit];
+            if (target >= 0 && static_cast<std::size_t>(target) < ButtonDebouncer::MAX_BUTTONS)
+            {
+                if (debouncer_.onEdge(target, (event.value & (1u << bit)) != 0, event.timestamp))
+                    stats_.bounces_filtered.inc();
+            }
+        }
+    }
+
+    DataWriteLock lock(*this);
+    ScopedLatency hold(stats_.lock_hold_ns, sampleLockTiming());
+    if (event.hat < current_data_.num_hats)
+    {
+        current_data_.hats[event.hat] = event.value;
+    }
+    else
+    {
+        stats_.dropped_events.inc();
+    }
+}
+
+void SimpleJoystick::handleBallEvent(const SDL_JoyBallEvent &event)
+{
+    if (!joystick_ || event.which != joystick_id_ || event.ball >= MAX_BALLS)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+    stats_.ball_events.inc();
+
+    addDelta(ball_delta_[event.ball], event.xrel, event.yrel);
+}
+
+void SimpleJoystick::addDelta(std::atomic<uint64_t> &slot, int32_t xrel, int32_t yrel)
+{
+    uint64_t packed = slot.load(std::memory_order_relaxed);
+    uint64_t next;
+    do
+    {
+        uint32_t dx = static_cast<uint32_t>(packed) + static_cast<uint32_t>(xrel);
+        uint32_t dy = static_cast<uint32_t>(packed >> 32) + static_cast<uint32_t>(yrel);
+        next = (static_cast<uint64_t>(dy) << 32) | dx;
+    } while (!slot.compare_exchange_weak(packed, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+void SimpleJoystick::unpackDelta(uint64_t packed, int &dx, int &dy)
+{
+    dx = static_cast<int32_t>(static_cast<uint32_t>(packed));
+    dy = static_cast<int32_t>(static_cast<uint32_t>(packed >> 32));
+}
+
+uint64_t SimpleJoystick::drainEvdev()
+{
+    uint64_t batch = 0;
+    EvdevEvent event;
+    while (evdev_->pop(event))
+    {
+        ++batch;
+        handleEvdevEvent(event);
+    }
+    return batch;
+}
+
+void SimpleJoystick::handleEvdevEvent(const EvdevEvent &event)
+{
+    constexpr uint16_t EVDEV_KEY = 0x01, EVDEV_REL = 0x02;
+    constexpr uint16_t BTN_MOUSE_LEFT = 0x110, BTN_MOUSE_MIDDLE = 0x112;
+    constexpr uint16_t REL_MOVE_X = 0x00, REL_MOVE_Y = 0x01, REL_SCROLL = 0x08;
+
+    if (event.type == EVDEV_KEY)
+    {
+        // 自动重复不改变状态
+        if (event.value == 2)
+            return;
+        bool down = event.value != 0;
+        DataWriteLock lock(*this);
+        if (event.code < 256)
+        {
+            stats_.key_events.inc();
+            uint64_t bit = uint64_t(1) << (event.code % 64);
+            uint64_t &word = current_data_.keys[event.code / 64];
+            word = down ? (word | bit) : (word & ~bit);
+        }
+        else if (event.code >= BTN_MOUSE_LEFT && event.code <= BTN_MOUSE_MIDDLE)
+        {
+            stats_.mouse_events.inc();
+            uint8_t bit = static_cast<uint8_t>(1u << (event.code - BTN_MOUSE_LEFT));
+            uint8_t &buttons = current_data_.mouse_buttons;
+            buttons = static_cast<uint8_t>(down ? (buttons | bit) : (buttons & ~bit));
+        }
+        else
+        {
+            stats_.dropped_events.inc();
+        }
+        return;
+    }
+
+    if (event.type == EVDEV_REL)
+    {
+        stats_.mouse_events.inc();
+        if (event.code == REL_MOVE_X)
+            addDelta(mouse_delta_, event.value, 0);
+        else if (event.code == REL_MOVE_Y)
+            addDelta(mouse_delta_, 0, event.value);
+        else if (event.code == REL_SCROLL)
+            mouse_wheel_.fetch_add(event.value, std::memory_order_relaxed);
+    }
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+void SimpleJoystick::handleSensorEvent(const SDL_ControllerSensorEvent &event)
+{
+    if (!sensor_controller_ || event.which != joystick_id_ ||
+        (event.sensor != SDL_SENSOR_ACCEL && event.sensor != SDL_SENSOR_GYRO))
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+    stats_.sensor_events.inc();
+
+    ImuSample sample;
+#if SDL_VERSION_ATLEAST(2, 26, 0)
+    sample.timestamp_us = event.timestamp_us ? event.timestamp_us : static_cast<uint64_t>(event.timestamp) * 1000u;
+#else
+    sample.timestamp_us = static_cast<uint64_t>(event.timestamp) * 1000u;
+#endif
+    sample.sensor = static_cast<uint8_t>(event.sensor);
+    sample.data[0] = event.data[0];
+    sample.data[1] = event.data[1];
+    sample.data[2] = event.data[2];
+    imu_samples_.push(sample);
+
+    if (options_.orientation)
+    {
+        if (event.sensor == SDL_SENSOR_ACCEL)
+        {
+            fusion_.onAccel(sample.data);
+        }
+        else
+        {
+            fusion_.onGyro(sample.data, sample.timestamp_us);
+            fusion_dirty_ = true;
+        }
+    }
+}
+#endif
+
+void SimpleJoystick::handleButtonEvent(const SDL_JoyButtonEvent &event)
+{
+    if (!joystick_ || event.which != joystick_id_)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+    stats_.button_events.inc();
+
+    bool pressed = event.state == SDL_PRESSED;
+    if (event.button < button_axis_route_.size() && button_axis_route_[event.button] >= 0)
+    {
+        DataWriteLock lock(*this);
+        applyDigitalAxis(button_axis_route_[event.button], pressed, event.timestamp);
+        return;
+    }
+
+    int target = event.button < button_route_.size() ? button_route_[event.button] : -1;
+    if (target < 0 || target >= num_buttons_)
+    {
+        stats_.dropped_events.inc();
+        return;
+    }
+
+    // 前 64 个按钮经过去抖, 结果在本轮事件处理结束时统一写入
+    if (static_cast<std::size_t>(target) < ButtonDebouncer::MAX_BUTTONS)
+    {
+        if (debouncer_.onEdge(target, pressed, event.timestamp))
+            stats_.bounces_filtered.inc();
+        return;
+    }
+
+    DataWriteLock lock(*this);
+    ScopedLatency hold(stats_.lock_hold_ns, sampleLockTiming());
+    if (static_cast<std::size_t>(target) < current_data_.buttons.size())
+    {
+        current_data_.buttons[target] = pressed;
+    }
+}
+
+bool SimpleJoystick::publishDebouncedButtons(uint32_t now_ms)
+{
+    uint64_t mask = debouncer_.update(now_ms);
+    if (mask == published_buttons_)
+        return false;
+    published_buttons_ = mask;
+
+    DataWriteLock lock(*this);
+    ScopedLatency hold(stats_.lock_hold_ns, sampleLockTiming());
+    std::size_t count = current_data_.buttons.size();
+    if (count > ButtonDebouncer::MAX_BUTTONS)
+        count = ButtonDebouncer::MAX_BUTTONS;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        current_data_.buttons[i] = ((mask >> i) & 1u) != 0;
+    }
+    return true;
+}
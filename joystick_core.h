@@ -0,0 +1,575 @@
+#pragma once
+
+// 摇杆输入引擎: 设备管理、事件线程和快照发布, 由 joystick_core 库提供
+#include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "axis_filter.h"
+#include "axis_history.h"
+#include "axis_pipeline.h"
+#include "button_debouncer.h"
+#include "controller_mapping.h"
+#include "evdev_input.h"
+#include "frame_signal.h"
+#include "haptic_output.h"
+#include "joystick_config.h"
+#include "joystick_hotplug.h"
+#include "joystick_metrics.h"
+#include "joystick_ring.h"
+#include "joystick_trace.h"
+#include "orientation_fusion.h"
+#include "realtime_thread.h"
+#include "stick_deadzone.h"
+#include "virtual_gamepad.h"
+
+constexpr std::size_t MAX_HATS = 4;
+constexpr std::size_t MAX_BALLS = 4;
+constexpr std::size_t MAX_TRIGGERS = 4;
+// 1000 Hz 的陀螺仪加加速度计约 4 秒
+constexpr std::size_t IMU_HISTORY = 8192;
+
+class JoystickObserver;
+
+// 构造参数
+struct JoystickOptions
+{
+    // 按 SDL 标准手柄布局 (A/B/X/Y、左右摇杆、扳机) 输出, 映射来自 SDL 内置数据库
+    bool game_controller = false;
+    // 自定义映射文件 (gamecontrollerdb.txt 格式), 优先于 SDL 内置数据库; 设置后也启用标准布局
+    std::string mappings_file;
+    // 震动/LED 输出后端, 为空时直接调用 SDL
+    std::shared_ptr<HapticBackend> haptic_backend;
+    // 记录每帧各处理阶段的耗时, 开销很小, 默认开启
+    bool trace = true;
+    // 打开设备的陀螺仪/加速度计 (需要 SDL 2.0.14+ 和 SDL 识别为手柄的设备)
+    bool sensors = false;
+    // 在事件线程上把 IMU 样本融合成姿态四元数写入快照, 会同时启用 sensors
+    bool orientation = false;
+    // Madgwick 修正增益: 越大越快收敛到重力方向, 也越容易受加速度干扰
+    float fusion_beta = 0.1f;
+    // 摇杆轴的默认滤波参数, 可用 setAxisFilter() 按轴修改
+    AxisFilterConfig axis_filter;
+    // 摇杆对及其二维死区; 为空时使用轴 0/1 和 2/3 两对 (标准布局下即左右摇杆)
+    std::vector<StickPairConfig> stick_pairs;
+    // 摇杆轴的自定义处理流水线 (见 DynamicAxisPipeline::parse), 替代内置的校准 → 滤波 → 死区;
+    // 设置后摇杆对的二维死区和 getPredictedData() 的外推不再生效
+    std::shared_ptr<const DynamicAxisPipeline> axis_pipeline;
+    // 通过 evdev 同时读取键盘和鼠标 (仅 Linux, 需要 /dev/input 读权限)
+    bool keyboard_mouse = false;
+    // 指定的 /dev/input/event* 设备; 为空时自动查找键盘和鼠标
+    std::vector<std::string> evdev_devices;
+    // 把处理后 (校准、滤波、映射) 的每帧写到虚拟手柄, 见 openVirtualGamepadSink(); 为空时不输出
+    std::shared_ptr<VirtualOutputSink> virtual_output;
+    // 帧发布和连接状态的观察者 (如 C 接口层), 为空时不回调
+    std::shared_ptr<JoystickObserver> observer;
+    // 事件线程最长多久取一次 SDL 事件 (毫秒); 对延迟敏感时调小, 如配合 realtime 设为 1
+    int poll_interval_ms = 60;
+    // 事件线程的 CPU 绑定、SCHED_FIFO 和内存锁定, 默认关闭
+    RealtimeConfig realtime;
+    // 运行参数文件 (格式见 parseJoystickConfig), 覆盖上面对应的选项; 修改后自动重新加载, 不用重启
+    std::string config_file;
+    // 按轴统计最近这些时间窗口 (毫秒) 内的最小/最大/平均值和速度, 最多 4 个, 用 axisStats() 读取; 为空时不记录
+    std::vector<uint32_t> axis_history_windows_ms;
+};
+
+// 一个 IMU 样本
+struct ImuSample
+{
+    uint64_t timestamp_us; // 传感器时间戳, SDL 不提供时为事件时间
+    uint8_t sensor;        // SDL_SENSOR_ACCEL (m/s^2) 或 SDL_SENSOR_GYRO (rad/s)
+    float data[3];
+};
+
+// 摇杆数据结构
+struct JoystickData
+{
+    std::vector<float> axes;
+    std::vector<bool> buttons;
+    // 以下为定长数组, 拷贝不涉及堆分配
+    std::array<uint8_t, MAX_HATS> hats{};        // SDL_HAT_UP/RIGHT/DOWN/LEFT 位组合
+    std::array<float, MAX_TRIGGERS> triggers{};  // 扳机 [0.0, 1.0], 静止为 0
+    uint8_t num_hats = 0;
+    uint8_t num_triggers = 0;
+    // true 时 axes/buttons 按 SDL_GameControllerAxis/SDL_GameControllerButton 排列
+    bool standard_layout = false;
+    // 帧号: 事件线程每处理一批新事件加一, 追踪时用来串联各阶段
+    uint64_t frame_id = 0;
+    // 姿态四元数 (w, x, y, z), 启用 orientation 且收到陀螺仪数据后有效
+    std::array<float, 4> orientation{{1.0f, 0.0f, 0.0f, 0.0f}};
+    bool has_orientation = false;
+    // 启用 keyboard_mouse 时有效: 按下的键 (evdev KEY_* 编码 0-255 的位图) 和鼠标按键 (bit0 左 bit1 右 bit2 中)
+    std::array<uint64_t, 4> keys{};
+    uint8_t mouse_buttons = 0;
+
+    bool keyDown(uint16_t code) const
+    {
+        return code < 256 && ((keys[code / 64] >> (code % 64)) & 1u);
+    }
+};
+
+// 事件线程上的回调 (初始状态和首次连接在构造函数中回调), 不能阻塞, 也不能调用 SimpleJoystick 的析构
+class JoystickObserver
+{
+public:
+    virtual ~JoystickObserver() {}
+    // 每个新帧发布时在持有快照锁的情况下调用, 只应拷贝需要的字段
+    virtual void capture(const JoystickData &data) = 0;
+    // capture() 之后、释放快照锁后调用
+    virtual void published() {}
+    virtual void connection(const ConnectionEvent &) {}
+};
+
+// 采集状态: RUNNING -> DRAINING (取完已排队的事件) -> PAUSED -> RUNNING, 任意状态都可进入 STOPPED
+enum class AcquisitionState : uint8_t
+{
+    RUNNING,
+    DRAINING,
+    PAUSED,
+    STOPPED
+};
+
+// 输入管线的指标, 注册一次后热路径只做分片计数
+struct PipelineMetrics
+{
+    explicit PipelineMetrics(MetricsRegistry &registry)
+        : axis_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"axis\"")),
+          button_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"button\"")),
+          hat_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"hat\"")),
+          sensor_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"sensor\"")),
+          ball_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"ball\"")),
+          key_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"key\"")),
+          mouse_events(registry.counter("joystick_events_total", "Input events handled by type", "type=\"mouse\"")),
+          dropped_events(registry.counter("joystick_events_dropped_total", "Events discarded (no device or index out of range)")),
+          bounces_filtered(registry.counter("joystick_button_bounces_filtered_total", "Button edges rejected by the debounce filter")),
+          connects(registry.counter("joystick_device_connects_total", "Device attach count")),
+          disconnects(registry.counter("joystick_device_disconnects_total", "Device detach count")),
+          failovers(registry.counter("joystick_device_failovers_total", "Active device replaced by a warm candidate")),
+          reconnect_requests(registry.counter("joystick_reconnect_requests_total", "Manual reconnect requests")),
+          connection_events_dropped(registry.counter("joystick_connection_events_dropped_total", "Connection events lost because the consumer queue was full")),
+          snapshot_reads(registry.counter("joystick_snapshot_reads_total", "getData() calls")),
+          haptic_requests(registry.counter("joystick_haptic_requests_total", "Rumble/LED requests posted")),
+          haptic_merged(registry.counter("joystick_haptic_requests_merged_total", "Requests superseded before reaching the device")),
+          haptic_applied(registry.counter("joystick_haptic_commands_total", "Rumble/LED commands sent to the device", "result=\"ok\"")),
+          haptic_failed(registry.counter("joystick_haptic_commands_total", "Rumble/LED commands sent to the device", "result=\"failed\"")),
+          virtual_frames(registry.counter("joystick_virtual_output_frames_total", "Frames written to the virtual output device")),
+          virtual_events(registry.counter("joystick_virtual_output_events_total", "Input events written to the virtual output device")),
+          virtual_errors(registry.counter("joystick_virtual_output_errors_total", "Frames the virtual output device did not accept")),
+          config_reloads(registry.counter("joystick_config_reloads_total", "Config file reloads", "result=\"ok\"")),
+          config_errors(registry.counter("joystick_config_reloads_total", "Config file reloads", "result=\"failed\"")),
+          connected(registry.gauge("joystick_connected", "1 when a device is open")),
+          acquisition_state(registry.gauge("joystick_acquisition_state", "0=running 1=draining 2=paused 3=stopped")),
+          drain_batch(registry.histogram("joystick_drain_batch_size", "Events drained per event loop cycle")),
+          lock_hold_ns(registry.histogram("joystick_lock_hold_ns", "data_mutex_ hold time in ns (sampled on the event thread)")),
+          wakeup_lateness_ns(registry.histogram("joystick_event_loop_wakeup_lateness_ns", "How late the event thread wakes up after a timed wait, in ns"))
+    {
+    }
+
+    MetricCounter &axis_events;
+    MetricCounter &button_events;
+    MetricCounter &hat_events;
+    MetricCounter &sensor_events;
+    MetricCounter &ball_events;
+    MetricCounter &key_events;
+    MetricCounter &mouse_events;
+    MetricCounter &dropped_events;
+    MetricCounter &bounces_filtered;
+    MetricCounter &connects;
+    MetricCounter &disconnects;
+    MetricCounter &failovers;
+    MetricCounter &reconnect_requests;
+    MetricCounter &connection_events_dropped;
+    MetricCounter &snapshot_reads;
+    MetricCounter &haptic_requests;
+    MetricCounter &haptic_merged;
+    MetricCounter &haptic_applied;
+    MetricCounter &haptic_failed;
+    MetricCounter &virtual_frames;
+    MetricCounter &virtual_events;
+    MetricCounter &virtual_errors;
+    MetricCounter &config_reloads;
+    MetricCounter &config_errors;
+    MetricGauge &connected;
+    MetricGauge &acquisition_state;
+    MetricHistogram &drain_batch;
+    MetricHistogram &lock_hold_ns;
+    MetricHistogram &wakeup_lateness_ns;
+};
+
+class SimpleJoystick
+{
+public:
+    explicit SimpleJoystick(const JoystickOptions &options = JoystickOptions());
+    ~SimpleJoystick();
+    JoystickData getData();
+
+    // 与 getData() 相同, 但每个线程缓存上一次读到的快照: 没有新数据时只有一次原子读, 不加锁也不拷贝。
+    // 返回的引用在本线程下一次调用前有效; 同一线程交替读取多个实例时缓存互相覆盖
+    const JoystickData &getCachedData();
+
+    // 与 getData() 相同, 但摇杆轴按滤波器估计的速度外推到 now + lead,
+    // 用来抵消从读取到实际使用之间的延迟; 外推量受各轴 max_prediction_ms 限制
+    JoystickData getPredictedData(std::chrono::milliseconds lead = std::chrono::milliseconds(0));
+
+    // 第 axis 个轴在第 window 个统计窗口 (JoystickOptions::axis_history_windows_ms 的顺序) 内的统计,
+    // 不加锁, 可在任意线程调用; 未启用、没有该轴或窗口时返回 false
+    bool axisStats(std::size_t axis, std::size_t window, AxisWindowStats &out) const
+    {
+        return axis_history_ && axis_history_->query(axis, window, out);
+    }
+
+    // 替换摇杆对及其死区参数, 可在任意线程调用
+    void setStickPairs(const std::vector<StickPairConfig> &pairs);
+
+    // 设置所有摇杆轴的滤波参数, 可在任意线程调用
+    void setAxisFilter(const AxisFilterConfig &config);
+
+    // 单独设置快照中第 axis 个轴的滤波参数
+    void setAxisFilter(std::size_t axis, const AxisFilterConfig &config);
+
+    MetricsRegistry &metrics()
+    {
+        return metrics_;
+    }
+
+    FrameTracer &tracer()
+    {
+        return tracer_;
+    }
+
+    // 事件线程实时配置的实际结果, 事件线程启动前为空
+    RealtimeStatus realtimeStatus();
+
+    // 换上新的运行参数, 可在任意线程调用; 事件线程在下一帧开始前采用, 之后不用加锁读取。
+    // 只有与上一版本不同的项才会应用: setButtonDebounce()、setAxisFilter()、setStickPairs() 在运行时
+    // 做的修改一直有效, 直到新版本改动了对应的去抖、滤波或摇杆对参数 (改动滤波时按轴的设置一并清除)
+    void applyConfig(std::shared_ptr<const JoystickConfig> config);
+
+    // 最近一次应用的运行参数, 从未应用过时为空
+    std::shared_ptr<const JoystickConfig> config();
+
+    // 每次 applyConfig 加一, 读者据此判断是否需要重新读取 config()
+    uint64_t configGeneration() const
+    {
+        return config_generation_.load(std::memory_order_acquire);
+    }
+
+    bool isRunning() const
+    {
+        return state_ == AcquisitionState::RUNNING;
+    }
+
+    AcquisitionState state() const
+    {
+        return state_;
+    }
+
+    // 暂停采集: 事件线程先处理完已排队的事件, 然后在条件变量上休眠, 设备保持打开
+    bool pause()
+    {
+        return transition(AcquisitionState::RUNNING, AcquisitionState::DRAINING);
+    }
+
+    // 继续采集, 暂停期间 SDL 队列里积累的事件照常处理
+    bool resume();
+
+    // 结束事件线程, 不可恢复
+    void stop();
+
+    // 阻塞到 last_seq 之后有新帧发布, 返回最新帧号 (即 JoystickData::frame_id), 可在任意线程调用;
+    // 所有等待者每帧只被唤醒一次。返回值等于 last_seq 表示超时、采集状态变化或停止
+    uint64_t waitForChange(uint64_t last_seq, std::chrono::milliseconds timeout)
+    {
+        return frame_signal_.wait(last_seq, timeout);
+    }
+
+    // 暂停期间阻塞调用线程, 采集恢复、停止或超时后返回当前状态
+    AcquisitionState waitWhilePaused(std::chrono::milliseconds timeout);
+
+    // 按钮去抖: 模式和窗口对所有按钮生效, 可在任意线程调用
+    void setButtonDebounce(DebounceMode mode, uint32_t window_ms);
+
+    // 单独设置某个按钮的去抖窗口 (如磨损严重的按钮)
+    void setButtonDebounceWindow(std::size_t button, uint32_t window_ms)
+    {
+        debouncer_.setWindow(button, window_ms);
+    }
+
+    // 取出轨迹球自上次读取以来累计的位移并清零
+    bool takeBallDelta(std::size_t ball, int &dx, int &dy);
+
+    // 取出鼠标自上次读取以来累计的位移和滚轮格数并清零
+    void takeMouseDelta(int &dx, int &dy, int &wheel);
+
+    // 请求事件线程关闭并重新枚举所有设备, 可在任意线程调用
+    void requestReconnect()
+    {
+        reconnect_requested_ = true;
+    }
+
+    // 震动, 强度 0-65535, duration_ms 后自动停止; 以下输出接口只写入邮箱, 不调用 SDL,
+    // 可在任意线程调用, 事件线程处理前的连续请求只保留最后一次
+    void rumble(uint16_t low_frequency, uint16_t high_frequency, uint32_t duration_ms)
+    {
+        postHaptic(HapticMailbox::RUMBLE, HapticMailbox::packRumble(low_frequency, high_frequency, duration_ms));
+    }
+
+    // 扳机震动 (部分手柄支持)
+    void rumbleTriggers(uint16_t left, uint16_t right, uint32_t duration_ms)
+    {
+        postHaptic(HapticMailbox::RUMBLE_TRIGGERS, HapticMailbox::packRumble(left, right, duration_ms));
+    }
+
+    // LED 颜色, 切换设备后自动恢复
+    void setLed(uint8_t red, uint8_t green, uint8_t blue);
+
+    // 批量读取 cursor 之后的 IMU 样本, 返回个数; 每个读者自己保存 cursor, 可在任意线程调用
+    // 读者落后超过缓冲容量时丢失的样本数累加到 lost
+    std::size_t readImu(uint64_t &cursor, ImuSample *out, std::size_t max, uint64_t *lost = nullptr) const
+    {
+        return imu_samples_.read(cursor, out, max, lost);
+    }
+
+    // 只读之后新到的样本时, 用它作为初始 cursor
+    uint64_t imuCursor() const
+    {
+        return imu_samples_.head();
+    }
+
+    // 当前设备已启用的传感器: bit0 加速度计, bit1 陀螺仪
+    uint8_t imuSensors() const
+    {
+        return imu_sensors_;
+    }
+
+    ConnectionState connectionState() const
+    {
+        return connection_state_;
+    }
+
+    // 取出一条连接状态变化, 只允许一个消费者线程调用
+    bool pollConnectionEvent(ConnectionEvent &event)
+    {
+        return connection_events_.pop(event);
+    }
+
+private:
+    void attachJoystick(SDL_Joystick *joystick, ConnectionState state);
+
+    // 按 GUID 查映射: 自定义映射文件优先, 其次 SDL 内置数据库
+    void resolveMapping(DeviceProfile &profile);
+
+    bool mappingEnabled() const
+    {
+        return options_.game_controller || !options_.mappings_file.empty();
+    }
+
+    // 生成原始索引 -> 快照索引的路由表; 没有映射时为恒等映射
+    void buildRoutes(const DeviceProfile &profile, int num_axes, int num_buttons);
+
+    // 把一个原始轴值按路由写入数据, 摇杆轴先滤波再应用死区; 调用方持有 data_mutex_
+    void applyAxis(std::size_t raw_axis, Sint16 raw_value, uint32_t timestamp_ms);
+
+    // 按当前设备的轴重新展开摇杆对; 调用方持有 data_mutex_
+    void configureStickPairs();
+
+    // 映射到轴的数字按钮 (如部分手柄的扳机), 调用方持有 data_mutex_
+    void applyDigitalAxis(int axis, bool pressed, uint32_t timestamp_ms);
+
+    // 传感器要通过 GameController 句柄打开, 与 joystick_ 共用同一个设备
+    void openSensors();
+    void closeSensors();
+    void detachJoystick();
+    void calibrateRest(DeviceProfile &profile, int num_axes);
+
+    // 当前设备失效后在同一轮事件处理中切换到备用设备, 没有备用设备则断开
+    void failoverJoystick();
+    void probeDevices();
+    void reconnect();
+
+    // 状态切换都在 state_mutex_ 下进行, 等待方不会错过通知
+    bool transition(AcquisitionState from, AcquisitionState to);
+    void publishConnection(ConnectionState state);
+    void postHaptic(HapticMailbox::Channel channel, uint64_t value);
+
+    // 经过 state_mutex_ 再通知, 事件线程检查完条件到开始等待之间不会漏掉唤醒
+    void wakeEventThread();
+
+    // 把邮箱里的最新输出下发到当前设备; 没有设备时丢弃 (LED 在设备接入时重发)
+    void applyHaptics();
+
+    // 本帧变化的值加 SYN_REPORT 一次 write() 写出
+    void writeVirtualOutput(uint64_t frame);
+
+    // 取出 SDL 队列中的全部事件, 返回事件数
+    uint64_t drainEvents(uint64_t frame);
+    void eventLoop();
+    void handleAxisEvent(const SDL_JoyAxisEvent &event);
+
+    // 修改 current_data_ 时代替 lock_guard: 解锁前推进快照代数, getCachedData() 据此判断缓存是否过期
+    class DataWriteLock
+    {
+    public:
+        explicit DataWriteLock(SimpleJoystick &owner)
+            : owner_(owner), lock_(owner.data_mutex_)
+        {
+        }
+
+        ~DataWriteLock()
+        {
+            owner_.data_generation_.fetch_add(1, std::memory_order_release);
+        }
+
+    private:
+        SimpleJoystick &owner_;
+        std::lock_guard<std::mutex> lock_;
+    };
+
+    // 调用方持有 data_mutex_
+    const AxisFilterConfig &axisFilterConfig(std::size_t axis) const
+    {
+        return axis < axis_filter_config_.size() ? axis_filter_config_[axis] : default_axis_filter_;
+    }
+
+    float normalizeAxis(std::size_t axis, Sint16 raw_value) const;
+
+    // 原始轴 raw_axis 映射到快照第 axis 个轴时的流水线上下文; 调用方持有 data_mutex_
+    AxisContext axisContext(std::size_t raw_axis, std::size_t axis, uint32_t timestamp_ms);
+
+    // 不属于摇杆对的轴使用单轴死区, 在滤波之后应用, 静止时的抖动先被平滑; 调用方持有 data_mutex_
+    float applyDeadzone(float value) const;
+
+    // 扳机从静止端点 -32768 映射到 [0.0, 1.0], 使用独立的小死区
+    float normalizeTrigger(Sint16 raw_value) const;
+
+    // 在监视线程上重新读取配置文件, 解析失败时保留当前参数
+    void reloadConfig();
+
+    // 事件线程在帧之间采用新的运行参数, 只应用与 previous 不同的项; previous 为空时全部应用
+    void adoptConfig(const JoystickConfig &config, const JoystickConfig *previous);
+    void handleHatEvent(const SDL_JoyHatEvent &event);
+
+    // 轨迹球是相对位移, 不进快照; x/y 打包成一个 64 位原子量累加, 由 takeBallDelta() 读取并清零
+    void handleBallEvent(const SDL_JoyBallEvent &event);
+
+    // 相对位移 x/y 各占 32 位, 读者用 exchange 一次取走两个分量
+    static void addDelta(std::atomic<uint64_t> &slot, int32_t xrel, int32_t yrel);
+    static void unpackDelta(uint64_t packed, int &dx, int &dy);
+
+    // 取出 evdev 队列中的键盘/鼠标事件, 返回事件数
+    uint64_t drainEvdev();
+
+    // 按键状态进快照; 鼠标移动和滚轮与轨迹球一样只累加, 由 takeMouseDelta() 读取
+    void handleEvdevEvent(const EvdevEvent &event);
+
+#if SDL_VERSION_ATLEAST(2, 0, 14)
+    // IMU 样本不进快照, 直接写入广播环形缓冲
+    void handleSensorEvent(const SDL_ControllerSensorEvent &event);
+#endif
+
+    void handleButtonEvent(const SDL_JoyButtonEvent &event);
+
+    // 把去抖后的按钮位图写入数据, 没有变化时不加锁; 返回按钮是否有变化
+    bool publishDebouncedButtons(uint32_t now_ms);
+
+    // 事件线程上每 64 次加锁计时一次, 读时钟的开销不计入每个事件
+    bool sampleLockTiming()
+    {
+        return (++lock_timing_tick_ & 63u) == 0;
+    }
+
+    JoystickOptions options_;
+    MappingTable mapping_table_;
+    MetricsRegistry metrics_;
+    FrameTracer tracer_;
+    PipelineMetrics stats_{metrics_};
+    uint32_t lock_timing_tick_ = 0;
+
+    // 以下设备状态只在事件线程访问
+    HotplugManager hotplug_;
+    SDL_Joystick *joystick_ = nullptr;
+    SDL_JoystickID joystick_id_ = -1;
+    std::string active_guid_;
+    std::vector<Sint16> axis_rest_;
+    // 原始索引 -> 快照索引的路由, 设备接入时生成
+    struct AxisRoute
+    {
+        int8_t axis = -1;        // 快照中的轴, -1 表示丢弃
+        int8_t trigger = -1;     // 扳机序号, -1 表示不是扳机
+        bool invert = false;
+        bool as_trigger = false; // 标准布局下扳机轴本身也按 [0, 1] 输出
+    };
+    std::vector<AxisRoute> axis_route_;
+    // 以下滤波状态和参数按快照中的轴索引, 受 data_mutex_ 保护
+    std::vector<AxisFilter> axis_filters_;
+    AxisFilterConfig default_axis_filter_;
+    std::vector<AxisFilterConfig> axis_filter_config_;
+    // 内置流水线, 死区在发布时按摇杆对或单轴应用
+    AxisPipeline<CalibrateStage, FilterStage> stick_pipeline_;
+    std::shared_ptr<const DynamicAxisPipeline> axis_pipeline_;
+    float axis_deadzone_ = 0.1f;
+    float trigger_deadzone_ = 0.02f;
+    // 滤波后、死区前的摇杆值, 摇杆对在帧发布时据此计算二维死区
+    std::vector<float> stick_values_;
+    std::vector<StickPairConfig> stick_pairs_;
+    std::vector<bool> stick_axes_;
+    StickDeadzones stick_deadzones_;
+    bool sticks_dirty_ = false;
+    std::vector<int16_t> button_route_;
+    std::vector<int8_t> button_axis_route_;
+    std::vector<std::array<int8_t, 4>> hat_route_;
+    int num_buttons_ = 0; // 快照中的按钮数
+    ButtonDebouncer debouncer_;
+    uint64_t published_buttons_ = 0;
+    uint32_t probe_tick_ = 0;
+    uint64_t frame_id_ = 0;
+    std::shared_ptr<HapticBackend> haptic_backend_;
+    std::shared_ptr<VirtualOutputSink> virtual_output_;
+    VirtualGamepad virtual_pad_;
+    std::shared_ptr<JoystickObserver> observer_;
+
+    std::atomic<uint64_t> ball_delta_[MAX_BALLS] = {};
+    std::atomic<uint64_t> mouse_delta_{0};
+    std::atomic<int32_t> mouse_wheel_{0};
+    std::atomic_bool reconnect_requested_{false};
+    std::atomic<ConnectionState> connection_state_{ConnectionState::DISCONNECTED};
+    SpscRing<ConnectionEvent, 16> connection_events_;
+    SDL_GameController *sensor_controller_ = nullptr;
+    std::atomic<uint8_t> imu_sensors_{0};
+    BroadcastRing<ImuSample> imu_samples_{IMU_HISTORY};
+    MadgwickFilter fusion_;
+    bool fusion_dirty_ = false;
+    // 每个轴事件记录一次 (摇杆轴记录死区之前的值), 每轮事件循环发布一次统计
+    std::unique_ptr<AxisHistory> axis_history_;
+    HapticMailbox haptics_;
+    std::atomic_bool led_set_{false};
+
+    JoystickData current_data_;
+    std::mutex data_mutex_;
+    std::atomic<uint64_t> data_generation_{1}; // 只在持有 data_mutex_ 时增加
+    const uint64_t instance_id_;
+    std::atomic<AcquisitionState> state_{AcquisitionState::STOPPED};
+    std::mutex state_mutex_;
+    std::condition_variable state_cv_;
+    FrameSignal frame_signal_;
+    std::thread event_thread_;
+    RealtimeStatus realtime_status_; // 受 state_mutex_ 保护
+
+    // 运行参数按 RCU 方式切换: 写者发布指针, 事件线程采用后回报; 回报之前的旧版本才会释放
+    JoystickConfig base_config_; // 启动时的参数, 每次重新加载都在它的副本上解析
+    std::mutex config_mutex_;    // 只在写者之间使用, 事件线程不取
+    std::vector<std::shared_ptr<const JoystickConfig>> config_history_;
+    std::atomic<const JoystickConfig *> config_{nullptr};
+    std::atomic<const JoystickConfig *> config_ack_{nullptr};
+    std::atomic<uint64_t> config_generation_{0};
+    const JoystickConfig *active_config_ = nullptr; // 只在事件线程访问
+    std::unique_ptr<EvdevInput> evdev_;
+    std::unique_ptr<ConfigWatcher> config_watcher_;
+};
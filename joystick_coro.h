@@ -0,0 +1,285 @@
+#pragma once
+
+// 协程接口 (C++20): co_await 下一帧、按钮按下、轴越过阈值; 需要链接 joystick_coro 目标
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "joystick_core.h"
+
+// 协程任务: 创建后立即运行到第一个 co_await, 结束后自动销毁; 任务内的异常无人接收, 直接终止程序
+struct JoystickTask
+{
+    struct promise_type
+    {
+        JoystickTask get_return_object() noexcept
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() noexcept
+        {
+        }
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+// 调度器作为 JoystickObserver 传给 SimpleJoystick, 在 run() 的线程上恢复协程
+// 等待的协程按条件挂在各自的索引上: 某帧只检查这帧按下的按钮和变化的轴, 其余等待者没有开销
+// 任务只能在 run() 的线程上 (或 run() 开始之前在同一线程上) 启动和 co_await
+class JoystickScheduler : public JoystickObserver
+{
+public:
+    // 按钮按位图保存, 只跟踪前 64 个按钮
+    static constexpr int MAX_BUTTONS = 64;
+
+    // co_await nextFrame() 的结果
+    struct Frame
+    {
+        uint64_t frame_id = 0;
+        uint64_t buttons = 0; // bit i 为第 i 个按钮 (i < MAX_BUTTONS)
+        std::vector<float> axes;
+    };
+
+    ~JoystickScheduler()
+    {
+        for (std::coroutine_handle<> handle : frame_waiters_)
+            handle.destroy();
+        for (auto &entry : button_waiters_)
+        {
+            for (std::coroutine_handle<> handle : entry.second)
+                handle.destroy();
+        }
+        for (auto &entry : axis_waiters_)
+        {
+            for (auto &waiter : entry.second)
+                waiter.second.handle.destroy();
+        }
+    }
+
+    // 事件线程: 只拷贝按钮位图和轴值; 两次唤醒之间按下的按钮都记录下来, 快速按下又松开也不会漏
+    void capture(const JoystickData &data) override
+    {
+        uint64_t buttons = 0;
+        for (std::size_t i = 0; i < data.buttons.size() && i < static_cast<std::size_t>(MAX_BUTTONS); ++i)
+        {
+            if (data.buttons[i])
+                buttons |= uint64_t(1) << i;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (has_captured_)
+            staged_pressed_ |= buttons & ~captured_buttons_;
+        captured_buttons_ = buttons;
+        has_captured_ = true;
+        staged_.frame_id = data.frame_id;
+        staged_.buttons = buttons;
+        staged_.axes.assign(data.axes.begin(), data.axes.end());
+        ++staged_seq_;
+    }
+
+    void published() override
+    {
+        cv_.notify_one();
+    }
+
+    // 在调用线程上处理新帧并恢复协程, stop() 后返回
+    void run()
+    {
+        while (true)
+        {
+            uint64_t pressed;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]
+                         { return stopped_ || staged_seq_ != seen_seq_; });
+                if (stopped_)
+                    return;
+                seen_seq_ = staged_seq_;
+                std::swap(current_, staged_);
+                pressed = staged_pressed_;
+                staged_pressed_ = 0;
+            }
+            dispatch(pressed);
+            std::swap(previous_, current_);
+        }
+    }
+
+    // 可在任意线程调用
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    struct FrameAwaiter
+    {
+        JoystickScheduler &scheduler;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.frame_waiters_.push_back(handle);
+        }
+        const Frame &await_resume() const noexcept
+        {
+            return scheduler.current_;
+        }
+    };
+
+    struct ButtonAwaiter
+    {
+        JoystickScheduler &scheduler;
+        int button;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.button_waiters_[button].push_back(handle);
+        }
+        // 按下时的帧号
+        uint64_t await_resume() const noexcept
+        {
+            return scheduler.current_.frame_id;
+        }
+    };
+
+    struct AxisAwaiter
+    {
+        JoystickScheduler &scheduler;
+        int axis;
+        float threshold;
+        float value = 0.0f;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.axis_waiters_[axis].emplace(threshold, AxisWaiter{handle, &value});
+        }
+        // 越过阈值后的轴值
+        float await_resume() const noexcept
+        {
+            return value;
+        }
+    };
+
+    // 下一个发布的帧 (多帧合并时为最新一帧)
+    FrameAwaiter nextFrame()
+    {
+        return FrameAwaiter{*this};
+    }
+
+    // 第 button 个按钮 (快照索引) 的下一次按下; 只支持 [0, MAX_BUTTONS), 超出时抛出异常而不是永远挂起
+    ButtonAwaiter buttonPressed(int button)
+    {
+        if (button < 0 || button >= MAX_BUTTONS)
+            throw std::runtime_error("buttonPressed: button " + std::to_string(button) + " out of range [0, " +
+                                     std::to_string(MAX_BUTTONS) + ")");
+        return ButtonAwaiter{*this, button};
+    }
+
+    // 第 axis 个轴在相邻两次处理之间越过 threshold (任一方向)
+    AxisAwaiter axisCrosses(int axis, float threshold)
+    {
+        return AxisAwaiter{*this, axis, threshold};
+    }
+
+private:
+    struct AxisWaiter
+    {
+        std::coroutine_handle<> handle;
+        float *value;
+    };
+
+    // 先取出本帧满足条件的等待者再恢复, 恢复后再次 co_await 的协程等待之后的帧
+    void dispatch(uint64_t pressed)
+    {
+        ready_.clear();
+        ready_.swap(frame_waiters_);
+
+        for (uint64_t bits = pressed; bits; bits &= bits - 1)
+        {
+            auto it = button_waiters_.find(__builtin_ctzll(bits));
+            if (it == button_waiters_.end())
+                continue;
+            ready_.insert(ready_.end(), it->second.begin(), it->second.end());
+            button_waiters_.erase(it);
+        }
+
+        // 换设备 (轴数变化) 的那一帧不判断越过
+        if (previous_.axes.size() == current_.axes.size())
+        {
+            for (auto &entry : axis_waiters_)
+            {
+                std::size_t axis = static_cast<std::size_t>(entry.first);
+                if (axis >= current_.axes.size())
+                    continue;
+                float before = previous_.axes[axis];
+                float after = current_.axes[axis];
+                if (before == after)
+                    continue;
+                // 阈值 t 被越过: before < t <= after 或 after < t <= before
+                auto &waiters = entry.second;
+                auto first = waiters.upper_bound(std::min(before, after));
+                auto last = waiters.upper_bound(std::max(before, after));
+                for (auto it = first; it != last; ++it)
+                {
+                    *it->second.value = after;
+                    ready_.push_back(it->second.handle);
+                }
+                waiters.erase(first, last);
+            }
+        }
+
+        for (std::coroutine_handle<> handle : ready_)
+            handle.resume();
+        ready_.clear();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    Frame staged_; // 以下四项受 mutex_ 保护
+    uint64_t staged_seq_ = 0;
+    uint64_t staged_pressed_ = 0;
+    bool stopped_ = false;
+    uint64_t captured_buttons_ = 0; // 只在事件线程访问
+    bool has_captured_ = false;
+
+    // 以下只在 run() 的线程访问
+    uint64_t seen_seq_ = 0;
+    Frame current_;
+    Frame previous_;
+    std::vector<std::coroutine_handle<>> frame_waiters_;
+    std::unordered_map<int, std::vector<std::coroutine_handle<>>> button_waiters_;
+    std::unordered_map<int, std::multimap<float, AxisWaiter>> axis_waiters_;
+    std::vector<std::coroutine_handle<>> ready_;
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "controller_mapping.h"
+
+// 按 GUID 保存的设备状态, 重连后原样恢复
+struct DeviceProfile
+{
+    std::string guid;
+    std::string name;
+    // 首次连接时记录的摇杆静止位置, 之后重连不再重新采样
+    std::vector<Sint16> axis_rest;
+    // 静止在负端点的轴视为模拟扳机
+    std::vector<int> trigger_axes;
+    // 标准布局映射, 为空表示按原始索引输出
+    std::shared_ptr<const ControllerMapping> mapping;
+    bool mapping_resolved = false;
+    bool calibrated = false;
+};
+
+enum class ConnectionState : uint8_t
+{
+    DISCONNECTED,
+    CONNECTED,
+    FAILOVER // 原设备拔出, 已切换到备用设备
+};
+
+// 发布给消费者的连接状态变化, 可平凡复制以便放进无锁队列
+struct ConnectionEvent
+{
+    ConnectionState state;
+    SDL_JoystickID instance_id;
+    char guid[33];
+};
+
+// 热插拔管理: 所有已插入的设备都提前打开放在候选列表里,
+// 当前设备拔出时直接切换到备用句柄, 不需要等待下一次 SDL_JoystickOpen
+// 只在事件线程 (以及事件线程启动前的构造阶段) 使用, 不加锁
+class HotplugManager
+{
+public:
+    ~HotplugManager()
+    {
+        closeAll();
+    }
+
+    // 枚举所有设备, 打开尚未在候选列表中的设备, 清理已失效的句柄
+    void probe()
+    {
+        for (auto it = candidates_.begin(); it != candidates_.end();)
+        {
+            if (!SDL_JoystickGetAttached(it->handle))
+            {
+                if (it->handle == active_)
+                    active_ = nullptr;
+                SDL_JoystickClose(it->handle);
+                it = candidates_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        int count = SDL_NumJoysticks();
+        for (int i = 0; i < count; ++i)
+            onDeviceAdded(i);
+    }
+
+    void onDeviceAdded(int device_index)
+    {
+        SDL_JoystickID id = SDL_JoystickGetDeviceInstanceID(device_index);
+        if (find(id))
+            return;
+
+        SDL_Joystick *handle = SDL_JoystickOpen(device_index);
+        if (!handle)
+            return;
+
+        Candidate c;
+        c.handle = handle;
+        c.id = SDL_JoystickInstanceID(handle);
+        c.guid = guidString(SDL_JoystickGetGUID(handle));
+        candidates_.push_back(c);
+    }
+
+    // 返回 true 表示拔出的是当前设备
+    bool onDeviceRemoved(SDL_JoystickID id)
+    {
+        for (auto it = candidates_.begin(); it != candidates_.end(); ++it)
+        {
+            if (it->id != id)
+                continue;
+            bool was_active = it->handle == active_;
+            if (was_active)
+                active_ = nullptr;
+            SDL_JoystickClose(it->handle);
+            candidates_.erase(it);
+            return was_active;
+        }
+        return false;
+    }
+
+    // 选一个候选设备作为当前设备: 优先同 GUID (同型号或同一设备), 否则取第一个
+    SDL_Joystick *failover(const std::string &preferred_guid)
+    {
+        active_ = nullptr;
+        for (const auto &c : candidates_)
+        {
+            if (!preferred_guid.empty() && c.guid == preferred_guid)
+            {
+                active_ = c.handle;
+                return active_;
+            }
+        }
+        if (!candidates_.empty())
+            active_ = candidates_.front().handle;
+        return active_;
+    }
+
+    void closeAll()
+    {
+        for (const auto &c : candidates_)
+            SDL_JoystickClose(c.handle);
+        candidates_.clear();
+        active_ = nullptr;
+    }
+
+    SDL_Joystick *active() const
+    {
+        return active_;
+    }
+
+    std::size_t candidateCount() const
+    {
+        return candidates_.size();
+    }
+
+    // 同一 GUID 的设备共用一份状态, 首次调用时创建
+    DeviceProfile &profileFor(SDL_Joystick *joystick)
+    {
+        std::string guid = guidString(SDL_JoystickGetGUID(joystick));
+        DeviceProfile &profile = profiles_[guid];
+        if (profile.guid.empty())
+        {
+            profile.guid = guid;
+            const char *name = SDL_JoystickName(joystick);
+            profile.name = name ? name : "";
+        }
+        return profile;
+    }
+
+    static std::string guidString(SDL_JoystickGUID guid)
+    {
+        char buf[33];
+        SDL_JoystickGetGUIDString(guid, buf, sizeof(buf));
+        return buf;
+    }
+
+private:
+    struct Candidate
+    {
+        SDL_Joystick *handle;
+        SDL_JoystickID id;
+        std::string guid;
+    };
+
+    const Candidate *find(SDL_JoystickID id) const
+    {
+        for (const auto &c : candidates_)
+        {
+            if (c.id == id)
+                return &c;
+        }
+        return nullptr;
+    }
+
+    std::vector<Candidate> candidates_;
+    std::map<std::string, DeviceProfile> profiles_;
+    SDL_Joystick *active_ = nullptr;
+};
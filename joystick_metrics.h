@@ -0,0 +1,358 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Prometheus 文本格式的指标注册表
+// 计数器/直方图按线程分片, 热路径只有一次无竞争的 relaxed fetch_add
+
+namespace metrics_detail
+{
+    constexpr std::size_t SHARDS = 16;
+    constexpr std::size_t CACHE_LINE = 64;
+
+    // 每个线程第一次使用时分配一个固定分片
+    inline std::size_t shardIndex()
+    {
+        static std::atomic<std::size_t> next_shard{0};
+        thread_local std::size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return index;
+    }
+
+    inline std::string joinLabels(const std::string &labels, const std::string &extra)
+    {
+        if (labels.empty() && extra.empty())
+            return "";
+        if (labels.empty())
+            return "{" + extra + "}";
+        if (extra.empty())
+            return "{" + labels + "}";
+        return "{" + labels + "," + extra + "}";
+    }
+}
+
+// 单调递增计数器
+class MetricCounter
+{
+public:
+    MetricCounter()
+    {
+        for (auto &shard : shards_)
+            shard.value.store(0, std::memory_order_relaxed);
+    }
+
+    void inc(uint64_t n = 1)
+    {
+        shards_[metrics_detail::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const
+    {
+        uint64_t total = 0;
+        for (const auto &shard : shards_)
+            total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    // 填充到缓存行, 避免不同线程的分片伪共享
+    struct Shard
+    {
+        std::atomic<uint64_t> value;
+        char pad[metrics_detail::CACHE_LINE - sizeof(std::atomic<uint64_t>)];
+    };
+    Shard shards_[metrics_detail::SHARDS];
+};
+
+// 可增可减的瞬时值
+class MetricGauge
+{
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// 以 2 的幂为桶边界的直方图: 桶 b 的上界为 2^b - 1
+class MetricHistogram
+{
+public:
+    static constexpr std::size_t BUCKETS = 32;
+
+    MetricHistogram()
+    {
+        for (auto &shard : shards_)
+        {
+            for (auto &bucket : shard.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            shard.sum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void observe(uint64_t v)
+    {
+        std::size_t b = v == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(v));
+        if (b >= BUCKETS)
+            b = BUCKETS - 1;
+        Shard &shard = shards_[metrics_detail::shardIndex()];
+        shard.buckets[b].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    void render(std::ostream &out, const std::string &name, const std::string &labels) const
+    {
+        uint64_t counts[BUCKETS] = {};
+        uint64_t sum = 0;
+        for (const auto &shard : shards_)
+        {
+            for (std::size_t b = 0; b < BUCKETS; ++b)
+                counts[b] += shard.buckets[b].load(std::memory_order_relaxed);
+            sum += shard.sum.load(std::memory_order_relaxed);
+        }
+
+        uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < BUCKETS - 1; ++b)
+        {
+            cumulative += counts[b];
+            uint64_t upper = (uint64_t(1) << b) - 1;
+            out << name << "_bucket"
+                << metrics_detail::joinLabels(labels, "le=\"" + std::to_string(upper) + "\"")
+                << " " << cumulative << "\n";
+        }
+        cumulative += counts[BUCKETS - 1];
+        out << name << "_bucket" << metrics_detail::joinLabels(labels, "le=\"+Inf\"") << " " << cumulative << "\n";
+        out << name << "_sum" << metrics_detail::joinLabels(labels, "") << " " << sum << "\n";
+        out << name << "_count" << metrics_detail::joinLabels(labels, "") << " " << cumulative << "\n";
+    }
+
+private:
+    struct Shard
+    {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> sum;
+        char pad[metrics_detail::CACHE_LINE];
+    };
+    Shard shards_[metrics_detail::SHARDS];
+};
+
+// 作用域计时, 纳秒写入直方图; enabled 为 false 时不读时钟
+class ScopedLatency
+{
+public:
+    ScopedLatency(MetricHistogram &histogram, bool enabled = true)
+        : histogram_(histogram), enabled_(enabled)
+    {
+        if (enabled_)
+            start_ = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedLatency()
+    {
+        if (enabled_)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            histogram_.observe(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+private:
+    MetricHistogram &histogram_;
+    bool enabled_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class MetricsRegistry
+{
+public:
+    // 注册只在初始化阶段发生; 同名同标签重复注册返回同一个对象
+    MetricCounter &counter(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        return *find(name, help, labels, Entry::COUNTER).counter;
+    }
+
+    MetricGauge &gauge(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        return *find(name, help, labels, Entry::GAUGE).gauge;
+    }
+
+    MetricHistogram &histogram(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        return *find(name, help, labels, Entry::HISTOGRAM).histogram;
+    }
+
+    std::string render() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream out;
+        std::vector<bool> emitted(entries_.size(), false);
+
+        // 同名指标聚在一起, 只输出一次 HELP/TYPE
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+            if (emitted[i])
+                continue;
+            const Entry &head = entries_[i];
+            out << "# HELP " << head.name << " " << head.help << "\n"
+                << "# TYPE " << head.name << " " << kindName(head.kind) << "\n";
+
+            for (std::size_t j = i; j < entries_.size(); ++j)
+            {
+                const Entry &e = entries_[j];
+                if (emitted[j] || e.name != head.name)
+                    continue;
+                emitted[j] = true;
+                switch (e.kind)
+                {
+                case Entry::COUNTER:
+                    out << e.name << metrics_detail::joinLabels(e.labels, "") << " " << e.counter->value() << "\n";
+                    break;
+                case Entry::GAUGE:
+                    out << e.name << metrics_detail::joinLabels(e.labels, "") << " " << e.gauge->value() << "\n";
+                    break;
+                case Entry::HISTOGRAM:
+                    e.histogram->render(out, e.name, e.labels);
+                    break;
+                }
+            }
+        }
+        return out.str();
+    }
+
+private:
+    struct Entry
+    {
+        enum Kind
+        {
+            COUNTER,
+            GAUGE,
+            HISTOGRAM
+        };
+
+        std::string name;
+        std::string help;
+        std::string labels;
+        Kind kind;
+        std::shared_ptr<MetricCounter> counter;
+        std::shared_ptr<MetricGauge> gauge;
+        std::shared_ptr<MetricHistogram> histogram;
+    };
+
+    static const char *kindName(Entry::Kind kind)
+    {
+        switch (kind)
+        {
+        case Entry::COUNTER:
+            return "counter";
+        case Entry::GAUGE:
+            return "gauge";
+        default:
+            return "histogram";
+        }
+    }
+
+    Entry &find(const std::string &name, const std::string &help, const std::string &labels, Entry::Kind kind)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &e : entries_)
+        {
+            if (e.name == name && e.labels == labels)
+            {
+                if (e.kind != kind)
+                    throw std::runtime_error("Metric type mismatch: " + name);
+                return e;
+            }
+        }
+
+        Entry e;
+        e.name = name;
+        e.help = help;
+        e.labels = labels;
+        e.kind = kind;
+        switch (kind)
+        {
+        case Entry::COUNTER:
+            e.counter = std::make_shared<MetricCounter>();
+            break;
+        case Entry::GAUGE:
+            e.gauge = std::make_shared<MetricGauge>();
+            break;
+        case Entry::HISTOGRAM:
+            e.histogram = std::make_shared<MetricHistogram>();
+            break;
+        }
+        entries_.push_back(e);
+        return entries_.back();
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+// 周期性把指标写到文件 (先写临时文件再 rename, 读取方不会看到半个文件)
+class MetricsFileExporter
+{
+public:
+    MetricsFileExporter(const MetricsRegistry &registry, const std::string &path,
+                        std::chrono::milliseconds interval)
+        : registry_(registry), path_(path), interval_(interval)
+    {
+        thread_ = std::thread(&MetricsFileExporter::run, this);
+    }
+
+    ~MetricsFileExporter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    bool dumpNow() const
+    {
+        std::string tmp = path_ + ".tmp";
+        {
+            std::ofstream out(tmp.c_str(), std::ios::trunc);
+            if (!out)
+                return false;
+            out << registry_.render();
+        }
+        return std::rename(tmp.c_str(), path_.c_str()) == 0;
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_)
+        {
+            cv_.wait_for(lock, interval_);
+            dumpNow();
+        }
+    }
+
+    const MetricsRegistry &registry_;
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
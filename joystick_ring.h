@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 单生产者/单消费者无锁环形队列, 满时 push 返回 false 由调用方决定丢弃策略
+template <typename T, std::size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    bool push(const T &item)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N)
+            return false;
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        item = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    T slots_[N];
+    // 生产者和消费者的索引放在不同缓存行
+    char pad0_[64];
+    std::atomic<std::size_t> head_{0};
+    char pad1_[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail_{0};
+};
+
+// 单生产者、任意多个读者的广播环形缓冲: 生产者从不等待, 覆盖最旧的数据;
+// 每个读者自己保存游标, 一次取出游标之后的一批数据
+// T 需要可平凡拷贝, 读者在拷贝后检查这段数据是否已被覆盖
+template <typename T>
+class BroadcastRing
+{
+public:
+    // capacity 取 2 的幂
+    explicit BroadcastRing(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    void push(const T &item)
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        // 先推进 claimed_, 读者据此判断拷贝期间哪些槽位可能被改写
+        claimed_.store(head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slots_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // 拷贝 cursor 之后最多 max 个元素到 out 并推进 cursor, 返回拷贝的个数;
+    // 读者落后超过容量时跳过被覆盖的部分, 跳过的个数累加到 lost
+    std::size_t read(uint64_t &cursor, T *out, std::size_t max, uint64_t *lost = nullptr) const
+    {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t skipped = 0;
+        if (head - cursor > slots_.size())
+        {
+            skipped = head - slots_.size() - cursor;
+            cursor = head - slots_.size();
+        }
+        std::size_t count = static_cast<std::size_t>(head - cursor < max ? head - cursor : max);
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = slots_[(cursor + i) & mask_];
+
+        // 拷贝期间被生产者覆盖的前缀作废
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+        uint64_t valid_from = claimed > slots_.size() ? claimed - slots_.size() : 0;
+        std::size_t first = 0;
+        if (valid_from > cursor)
+        {
+            first = static_cast<std::size_t>(valid_from - cursor < count ? valid_from - cursor : count);
+            skipped += first;
+            for (std::size_t i = first; i < count; ++i)
+                out[i - first] = out[i];
+        }
+        cursor += count;
+        if (lost)
+            *lost += skipped;
+        return count - first;
+    }
+
+    // 当前写入位置, 新读者从这里开始只读之后的数据
+    uint64_t head() const
+    {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const
+    {
+        return slots_.size();
+    }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_ = 0;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> claimed_{0};
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 按输入帧的端到端追踪: 每个阶段记录一条带帧号的区间, 写入固定大小的环形缓冲,
+// 导出为 Chrome trace_event JSON (chrome://tracing 或 Perfetto 打开)
+// 记录只有一次 fetch_add 和几次普通写, 不分配内存、不加锁, 可以常开
+class FrameTracer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // capacity 取 2 的幂, 缓冲满后覆盖最旧的记录
+    explicit FrameTracer(std::size_t capacity = 4096)
+        : mask_(roundUp(capacity) - 1), slots_(mask_ + 1)
+    {
+    }
+
+    void setEnabled(bool enabled)
+    {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool enabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+    // 记录一个已结束的阶段; name 必须是静态字符串
+    void record(const char *name, uint64_t frame_id, uint64_t start_ns, uint64_t end_ns, uint64_t arg = 0)
+    {
+        if (!enabled())
+            return;
+        uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+        Slot &slot = slots_[index & mask_];
+        // 每个槽位一个序号, 导出时跳过正在写的槽位
+        slot.seq.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name = name;
+        slot.frame_id = frame_id;
+        slot.start_ns = start_ns;
+        slot.end_ns = end_ns;
+        slot.arg = arg;
+        slot.tid = threadIndex();
+        slot.seq.store(index * 2 + 2, std::memory_order_release);
+    }
+
+    // 给当前线程命名, 导出时显示在时间线上
+    void nameThread(const char *name)
+    {
+        std::lock_guard<std::mutex> lock(names_mutex_);
+        thread_names_[threadIndex()] = name;
+    }
+
+    // 导出当前缓冲中的记录; 同一帧的各阶段用 flow 箭头串起来, 跨线程也能看到因果关系
+    bool exportChromeJson(const std::string &path) const
+    {
+        std::vector<Record> records = snapshot();
+        std::sort(records.begin(), records.end(), [](const Record &a, const Record &b)
+                  { return a.start_ns < b.start_ns; });
+
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp.c_str(), std::ios::trunc);
+            if (!out)
+                return false;
+
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            bool first = true;
+            {
+                std::lock_guard<std::mutex> lock(names_mutex_);
+                for (const auto &entry : thread_names_)
+                {
+                    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                        << entry.first << ",\"args\":{\"name\":\"" << entry.second << "\"}}";
+                    first = false;
+                }
+            }
+
+            std::map<uint64_t, std::size_t> remaining;
+            for (const Record &r : records)
+            {
+                if (r.frame_id)
+                    ++remaining[r.frame_id];
+            }
+            std::map<uint64_t, bool> started;
+
+            char buf[256];
+            for (const Record &r : records)
+            {
+                std::snprintf(buf, sizeof(buf),
+                              "\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                              "\"args\":{\"frame\":%llu,\"arg\":%llu}}",
+                              r.name, r.tid, r.start_ns / 1000.0, (r.end_ns - r.start_ns) / 1000.0,
+                              static_cast<unsigned long long>(r.frame_id), static_cast<unsigned long long>(r.arg));
+                out << (first ? "" : ",") << buf;
+                first = false;
+
+                if (!r.frame_id)
+                    continue;
+                std::size_t &left = remaining[r.frame_id];
+                --left;
+                bool &has_start = started[r.frame_id];
+                const char *phase = !has_start ? "s" : (left == 0 ? "f" : "t");
+                if (!has_start && left == 0)
+                    continue; // 只有一个阶段的帧不画箭头
+                has_start = true;
+                std::snprintf(buf, sizeof(buf),
+                              ",\n{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"%s\",\"bp\":\"e\",\"id\":%llu,"
+                              "\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                              phase, static_cast<unsigned long long>(r.frame_id), r.tid, r.start_ns / 1000.0);
+                out << buf;
+            }
+            out << "\n]}\n";
+        }
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        const char *name = nullptr;
+        uint64_t frame_id = 0;
+        uint64_t start_ns = 0;
+        uint64_t end_ns = 0;
+        uint64_t arg = 0;
+        uint32_t tid = 0;
+    };
+
+    struct Record
+    {
+        const char *name;
+        uint64_t frame_id;
+        uint64_t start_ns;
+        uint64_t end_ns;
+        uint64_t arg;
+        uint32_t tid;
+    };
+
+    static std::size_t roundUp(std::size_t n)
+    {
+        std::size_t size = 1;
+        while (size < n)
+            size <<= 1;
+        return size;
+    }
+
+    static uint32_t threadIndex()
+    {
+        static std::atomic<uint32_t> next{1};
+        thread_local uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    std::vector<Record> snapshot() const
+    {
+        std::vector<Record> records;
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t begin = head > slots_.size() ? head - slots_.size() : 0;
+        records.reserve(static_cast<std::size_t>(head - begin));
+        for (uint64_t index = begin; index < head; ++index)
+        {
+            const Slot &slot = slots_[index & mask_];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != index * 2 + 2)
+                continue;
+            Record r;
+            r.name = slot.name;
+            r.frame_id = slot.frame_id;
+            r.start_ns = slot.start_ns;
+            r.end_ns = slot.end_ns;
+            r.arg = slot.arg;
+            r.tid = slot.tid;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq || !r.name)
+                continue;
+            records.push_back(r);
+        }
+        return records;
+    }
+
+    std::atomic_bool enabled_{true};
+    std::size_t mask_;
+    std::vector<Slot> slots_;
+    std::atomic<uint64_t> head_{0};
+    mutable std::mutex names_mutex_;
+    std::map<uint32_t, std::string> thread_names_;
+};
+
+// 作用域内的阶段, 析构时记录; tracer 为空时不做任何事
+class TraceScope
+{
+public:
+    TraceScope(FrameTracer *tracer, const char *name, uint64_t frame_id = 0)
+        : tracer_(tracer && tracer->enabled() ? tracer : nullptr), name_(name), frame_id_(frame_id),
+          start_ns_(tracer_ ? FrameTracer::now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (tracer_)
+            tracer_->record(name_, frame_id_, start_ns_, FrameTracer::now(), arg_);
+    }
+
+    void setArg(uint64_t arg)
+    {
+        arg_ = arg;
+    }
+
+    // 放弃记录 (如本轮没有事件)
+    void cancel()
+    {
+        tracer_ = nullptr;
+    }
+
+private:
+    TraceScope(const TraceScope &);
+    TraceScope &operator=(const TraceScope &);
+
+    FrameTracer *tracer_;
+    const char *name_;
+    uint64_t frame_id_;
+    uint64_t start_ns_;
+    uint64_t arg_ = 0;
+};
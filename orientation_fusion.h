@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Madgwick 姿态融合 (只用陀螺仪 + 加速度计), 每个样本固定开销, 无分配
+// 陀螺仪积分给出姿态变化, 加速度计测得的重力方向按 beta 的比例做梯度下降修正漂移
+// 四元数 (w, x, y, z) 以 SDL 传感器坐标系表示: 手柄平放时 +Y 朝上, +Z 朝向玩家
+class MadgwickFilter
+{
+public:
+    explicit MadgwickFilter(float beta = 0.1f)
+        : beta_(beta)
+    {
+    }
+
+    void setBeta(float beta)
+    {
+        beta_ = beta;
+    }
+
+    void reset()
+    {
+        q_ = {{1.0f, 0.0f, 0.0f, 0.0f}};
+        has_gyro_time_ = false;
+        has_accel_ = false;
+    }
+
+    // 加速度计只更新最新的重力方向, 在下一个陀螺仪样本时参与融合
+    void onAccel(const float accel[3])
+    {
+        accel_[0] = accel[0];
+        accel_[1] = accel[1];
+        accel_[2] = accel[2];
+        has_accel_ = true;
+    }
+
+    // 陀螺仪 (rad/s) 按样本时间戳积分; 间隔异常 (首个样本、乱序、断流) 时只记录时间
+    void onGyro(const float gyro[3], uint64_t timestamp_us)
+    {
+        constexpr uint64_t MAX_GAP_US = 100000;
+        uint64_t last = last_gyro_us_;
+        bool valid = has_gyro_time_ && timestamp_us > last && timestamp_us - last <= MAX_GAP_US;
+        last_gyro_us_ = timestamp_us;
+        has_gyro_time_ = true;
+        if (!valid)
+            return;
+        update(gyro, static_cast<float>(timestamp_us - last) * 1e-6f);
+    }
+
+    const std::array<float, 4> &quaternion() const
+    {
+        return q_;
+    }
+
+private:
+    void update(const float gyro[3], float dt)
+    {
+        float q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+        float gx = gyro[0], gy = gyro[1], gz = gyro[2];
+
+        // 陀螺仪给出的四元数变化率
+        float qdot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+        float qdot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+        float qdot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+        float qdot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+        float ax = accel_[0], ay = accel_[1], az = accel_[2];
+        float anorm = ax * ax + ay * ay + az * az;
+        if (has_accel_ && anorm > 0.0f)
+        {
+            float recip = 1.0f / std::sqrt(anorm);
+            ax *= recip;
+            ay *= recip;
+            az *= recip;
+
+            // 目标函数: 姿态预测的重力方向 (旋转矩阵第二行) 与实测方向之差, s 为其梯度
+            float f0 = 2.0f * (q1 * q2 + q0 * q3) - ax;
+            float f1 = 1.0f - 2.0f * (q1 * q1 + q3 * q3) - ay;
+            float f2 = 2.0f * (q2 * q3 - q0 * q1) - az;
+            float s0 = 2.0f * q3 * f0 - 2.0f * q1 * f2;
+            float s1 = 2.0f * q2 * f0 - 4.0f * q1 * f1 - 2.0f * q0 * f2;
+            float s2 = 2.0f * q1 * f0 + 2.0f * q3 * f2;
+            float s3 = 2.0f * q0 * f0 - 4.0f * q3 * f1 + 2.0f * q2 * f2;
+            float snorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+            if (snorm > 0.0f)
+            {
+                recip = beta_ / std::sqrt(snorm);
+                qdot0 -= s0 * recip;
+                qdot1 -= s1 * recip;
+                qdot2 -= s2 * recip;
+                qdot3 -= s3 * recip;
+            }
+        }
+
+        q0 += qdot0 * dt;
+        q1 += qdot1 * dt;
+        q2 += qdot2 * dt;
+        q3 += qdot3 * dt;
+        float recip = 1.0f / std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q_ = {{q0 * recip, q1 * recip, q2 * recip, q3 * recip}};
+    }
+
+    float beta_;
+    std::array<float, 4> q_{{1.0f, 0.0f, 0.0f, 0.0f}};
+    float accel_[3] = {0.0f, 0.0f, 0.0f};
+    bool has_accel_ = false;
+    uint64_t last_gyro_us_ = 0;
+    bool has_gyro_time_ = false;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+// 事件线程的实时配置, 默认全部关闭; 每一项单独生效, 没有权限时跳过该项并记录原因
+struct RealtimeConfig
+{
+    int cpu = -1;      // 绑定到该 CPU, -1 表示不绑定
+    int priority = 0;  // SCHED_FIFO 优先级 1-99, 0 表示保持普通调度
+    bool lock_memory = false; // mlockall 锁定进程内存 (对整个进程生效), 并禁止 malloc 把内存还给系统
+    std::size_t prefault_stack = 256 * 1024; // 线程启动时预先触碰的栈大小, 只在以上任一项启用时生效
+
+    bool enabled() const
+    {
+        return cpu >= 0 || priority > 0 || lock_memory;
+    }
+};
+
+// 实际生效的结果
+struct RealtimeStatus
+{
+    bool affinity = false;
+    bool fifo = false;
+    bool memory_locked = false;
+    std::string errors; // 失败的项及原因, 全部成功时为空
+};
+
+namespace realtime_detail
+{
+    inline void appendError(RealtimeStatus &status, const char *what, int error)
+    {
+        if (!status.errors.empty())
+            status.errors += "; ";
+        status.errors += what;
+        status.errors += ": ";
+        status.errors += std::strerror(error);
+    }
+
+#ifdef __linux__
+    // 单独的函数, 返回后这段栈已经映射 (mlockall 之后也被锁定), 运行中不会再缺页
+    __attribute__((noinline)) inline void prefaultStack(std::size_t bytes)
+    {
+        volatile char *stack = static_cast<volatile char *>(alloca(bytes));
+        for (std::size_t i = 0; i < bytes; i += 4096)
+            stack[i] = 0;
+    }
+#endif
+}
+
+// 在目标线程内调用, 配置当前线程
+inline RealtimeStatus applyRealtime(const RealtimeConfig &config)
+{
+    RealtimeStatus status;
+    if (!config.enabled())
+        return status;
+#ifdef __linux__
+    if (config.lock_memory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        {
+            status.memory_locked = true;
+            // 释放的堆内存留在进程内, 之后的分配不会再触发缺页
+            mallopt(M_TRIM_THRESHOLD, -1);
+            mallopt(M_MMAP_MAX, 0);
+        }
+        else
+        {
+            realtime_detail::appendError(status, "mlockall", errno);
+        }
+    }
+    if (config.prefault_stack)
+        realtime_detail::prefaultStack(config.prefault_stack);
+
+    if (config.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error == 0)
+            status.affinity = true;
+        else
+            realtime_detail::appendError(status, "affinity", error);
+    }
+    if (config.priority > 0)
+    {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = config.priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error == 0)
+            status.fifo = true;
+        else
+            realtime_detail::appendError(status, "SCHED_FIFO", error);
+    }
+#else
+    status.errors = "realtime mode not supported on this platform";
+#endif
+    return status;
+}
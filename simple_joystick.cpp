@@ -3,177 +3,17 @@
 #include <vector>
 #include <thread>
 #include <atomic>
-#include <mutex>
 #include <chrono>
-#include <cmath>
-#include <stdexcept>
-#include <condition_variable> // 添加条件变量
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include "command_scheduler.h"
+#include "fixed_rate_sampler.h"
+#include "joystick_core.h"
 
 using namespace std::chrono;
 
-// 摇杆数据结构
-struct JoystickData
-{
-    std::vector<float> axes;
-    std::vector<bool> buttons;
-};
-
-class SimpleJoystick
-{
-public:
-    SimpleJoystick()
-    {
-        if (SDL_Init(SDL_INIT_JOYSTICK) < 0)
-        {
-            throw std::runtime_error("SDL init failed: " + std::string(SDL_GetError()));
-        }
-
-        // 打开第一个可用摇杆
-        if (SDL_NumJoysticks() > 0)
-        {
-            // 打开设备
-            joystick_ = SDL_JoystickOpen(0);
-            if (joystick_)
-            {
-                initJoystick();
-            }
-        }
-
-        // 启动事件线程
-        running_ = true;
-        event_thread_ = std::thread(&SimpleJoystick::eventLoop, this);
-    }
-
-    ~SimpleJoystick()
-    {
-        running_ = false;
-        if (event_thread_.joinable())
-        {
-            event_thread_.join();
-        }
-        if (joystick_)
-        {
-            SDL_JoystickClose(joystick_);
-        }
-        SDL_Quit();
-    }
-
-    JoystickData getData()
-    {
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        return current_data_;
-    }
-
-    bool isRunning() const
-    {
-        return running_;
-    }
-
-    void stop()
-    {
-        running_ = false;
-    }
-
-private:
-    void initJoystick()
-    {
-        // 初始化数据结构
-        int num_axes = SDL_JoystickNumAxes(joystick_);
-        int num_buttons = SDL_JoystickNumButtons(joystick_);
-
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        current_data_.axes.resize(num_axes, 0.0f);
-        current_data_.buttons.resize(num_buttons, false);
-
-        std::cout << "Joystick connected: " << SDL_JoystickName(joystick_) << std::endl
-                  << "ID: " << SDL_JoystickInstanceID(joystick_) << std::endl
-                  << "Axes: " << num_axes
-                  << ", Buttons: " << num_buttons << std::endl;
-    }
-
-    void eventLoop()
-    {
-        constexpr int POLL_INTERVAL_MS = 60;
-
-        while (running_)
-        {
-            SDL_Event event;
-            while (SDL_PollEvent(&event))
-            {
-                switch (event.type)
-                {
-                case SDL_JOYAXISMOTION:
-                    handleAxisEvent(event.jaxis);
-                    break;
-                case SDL_JOYBUTTONDOWN:
-                case SDL_JOYBUTTONUP:
-                    handleButtonEvent(event.jbutton);
-                    break;
-                case SDL_JOYDEVICEADDED:
-                    if (!joystick_)
-                    {
-                        joystick_ = SDL_JoystickOpen(event.jdevice.which);
-                        if (joystick_)
-                            initJoystick();
-                    }
-                    break;
-                case SDL_JOYDEVICEREMOVED:
-                    if (joystick_ && event.jdevice.which == SDL_JoystickInstanceID(joystick_))
-                    {
-                        SDL_JoystickClose(joystick_);
-                        joystick_ = nullptr;
-                        std::cout << "Joystick disconnected" << std::endl;
-                    }
-                    break;
-                }
-            }
-            std::this_thread::sleep_for(milliseconds(POLL_INTERVAL_MS));
-        }
-    }
-
-    void handleAxisEvent(const SDL_JoyAxisEvent &event)
-    {
-        if (!joystick_)
-            return;
-
-        // 标准化轴值到 [-1.0, 1.0]
-        float value = static_cast<float>(event.value) / 32767.0f;
-        if (value > 1.0f)
-            value = 1.0f;
-        if (value < -1.0f)
-            value = -1.0f;
-
-        // 应用死区过滤
-        constexpr float DEADZONE = 0.1f;
-        if (fabs(value) < DEADZONE)
-            value = 0.0f;
-
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        if (event.axis < current_data_.axes.size())
-        {
-            current_data_.axes[event.axis] = value;
-        }
-    }
-
-    void handleButtonEvent(const SDL_JoyButtonEvent &event)
-    {
-        if (!joystick_)
-            return;
-
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        if (event.button < current_data_.buttons.size())
-        {
-            current_data_.buttons[event.button] = (event.state == SDL_PRESSED);
-        }
-    }
-
-    SDL_Joystick *joystick_ = nullptr;
-    JoystickData current_data_;
-    std::mutex data_mutex_;
-    std::atomic_bool running_{false};
-    std::thread event_thread_;
-};
-
 // 键盘监听线程
 void keyboardListener(std::atomic_bool &running, SimpleJoystick &joystick)
 {
@@ -192,15 +32,17 @@ void keyboardListener(std::atomic_bool &running, SimpleJoystick &joystick)
             switch (cmd)
             {
             case 's': // 暂停/继续
-                if (joystick.isRunning())
+                if (joystick.pause())
                 {
-                    joystick.stop();
                     std::cout << "摇杆数据采集已暂停" << std::endl;
                 }
+                else if (joystick.resume())
+                {
+                    std::cout << "摇杆数据采集已继续" << std::endl;
+                }
                 else
                 {
-                    // 无法直接重启，需要重新创建对象
-                    std::cout << "无法直接重启，请重新运行程序" << std::endl;
+                    std::cout << "采集已停止" << std::endl;
                 }
                 break;
 
@@ -211,16 +53,14 @@ void keyboardListener(std::atomic_bool &running, SimpleJoystick &joystick)
                 break;
 
             case 'r': // 重新连接
-                if (!joystick.isRunning())
+                if (joystick.state() == AcquisitionState::STOPPED)
                 {
                     std::cout << "无法重新连接，采集已停止" << std::endl;
                 }
                 else
                 {
                     std::cout << "尝试重新连接摇杆..." << std::endl;
-                    // // 在实际应用中，这里应该实现重新连接逻辑
-                    // // 这里只是模拟
-                    // std::cout << "摇杆重新连接功能需在完整实现中添加" << std::endl;
+                    joystick.requestReconnect();
                 }
                 break;
 
@@ -236,51 +76,251 @@ void keyboardListener(std::atomic_bool &running, SimpleJoystick &joystick)
     }
 }
 
-// // 处理按钮命令的函数
-// void handleButtonCommand(int buttonId)
-// {
-//     // 根据按钮ID执行不同的命令
-//     switch (buttonId)
-//     {
-//     case 0: // A按钮
-//         std::cout << "\n命令: A按钮按下 - " << std::endl;
-//         break;
-//     case 1: // B按钮
-//         std::cout << "\n命令: B按钮按下 - " << std::endl;
-//         break;
-//     case 2: // X按钮
-//         std::cout << "\n命令: X按钮按下 - " << std::endl;
-//         break;
-//     case 3: // Y按钮
-//         std::cout << "\n命令: Y按钮按下 - " << std::endl;
-//         break;
-//     case 4: // LB按钮
-//         std::cout << "\n命令: LB按钮按下 - " << std::endl;
-//         break;
-//     case 5: // RB按钮
-//         std::cout << "\n命令: RB按钮按下 -  " << std::endl;
-//         break;
-//     default:
-//         std::cout << "\n命令: 按钮" << buttonId << "按下" << std::endl;
-//     }
-// }
-
-int main()
+// 按钮到命令的映射: 原始索引依赖手柄型号, 标准布局索引在所有设备上一致; key 为同名键盘键 (evdev 编码)
+struct ButtonCommand
+{
+    int raw_button;
+    int standard_button;
+    int key;
+    int command;
+    const char *label;
+};
+
+const ButtonCommand BUTTON_COMMANDS[] = {
+    {0, SDL_CONTROLLER_BUTTON_X, 45, 3, "按钮X"}, // X按钮 (第一位), KEY_X
+    {1, SDL_CONTROLLER_BUTTON_A, 30, 1, "按钮A"}, // A按钮 (第二位), KEY_A
+    {2, SDL_CONTROLLER_BUTTON_B, 48, 2, "按钮B"}, // B按钮 (第三位), KEY_B
+    {3, SDL_CONTROLLER_BUTTON_Y, 21, 4, "按钮Y"}, // Y按钮 (第四位), KEY_Y
+};
+
+// 把不同设备的输入绑定到同一个动作, 上层只关心动作而不关心来源
+class ActionMap
+{
+public:
+    // action 取 0-63
+    void bind(InputSource source, int code, int action)
+    {
+        bindings_.push_back(Binding{source, code, action});
+    }
+
+    void clear()
+    {
+        bindings_.clear();
+    }
+
+    // 返回当前处于按下状态的动作位图 (bit action)
+    uint64_t evaluate(const JoystickData &data) const
+    {
+        uint64_t active = 0;
+        for (const Binding &binding : bindings_)
+        {
+            if (pressed(binding, data))
+                active |= uint64_t(1) << binding.action;
+        }
+        return active;
+    }
+
+private:
+    struct Binding
+    {
+        InputSource source;
+        int code;
+        int action;
+    };
+
+    static bool pressed(const Binding &binding, const JoystickData &data)
+    {
+        switch (binding.source)
+        {
+        case InputSource::JOYSTICK_BUTTON:
+        case InputSource::CONTROLLER_BUTTON:
+            if (data.standard_layout != (binding.source == InputSource::CONTROLLER_BUTTON))
+                return false;
+            return binding.code >= 0 && static_cast<std::size_t>(binding.code) < data.buttons.size() &&
+                   data.buttons[binding.code];
+        case InputSource::KEY:
+            return binding.code >= 0 && data.keyDown(static_cast<uint16_t>(binding.code));
+        case InputSource::MOUSE_BUTTON:
+            return binding.code >= 0 && binding.code < 8 && ((data.mouse_buttons >> binding.code) & 1u);
+        }
+        return false;
+    }
+
+    std::vector<Binding> bindings_;
+};
+
+const ButtonCommand *findCommandById(int command)
+{
+    for (const auto &entry : BUTTON_COMMANDS)
+    {
+        if (entry.command == command)
+            return &entry;
+    }
+    return nullptr;
+}
+
+int main(int argc, char **argv)
 {
     try
     {
+        // --gamecontroller: 使用 SDL 标准手柄布局; --mappings <文件>: 自定义映射
+        // --sensors: 读取陀螺仪/加速度计; --orientation: 融合成姿态四元数; --trace <文件>: 退出时导出 Chrome trace_event JSON
+        // --filter off|one-euro|kalman: 摇杆轴滤波方式, 默认 one-euro
+        // --keyboard-mouse: 键盘 A/B/X/Y 和鼠标左键 (同 A) 也能触发命令
+        // --virtual-output <文件>: 处理后的输入输出到 uinput 虚拟手柄, /dev/uinput 不可用时写入该文件
+        // --poll-interval <毫秒>: 事件线程轮询间隔; --rt-cpu <n> / --rt-priority <1-99> / --mlock: 事件线程实时配置
+        // --sample-rate <Hz>: 按固定频率读取快照; --interpolate: 摇杆轴取节拍时刻的估计值
+        // --pipeline <阶段列表>: 摇杆轴处理流水线, 如 calibrate,filter,deadzone:0.15,curve:2
+        // --config <文件>: 死区、滤波、轮询间隔、去抖和按钮绑定, 修改后自动生效
+        // --history <毫秒>: 显示轴 0/1 在该时间窗口内的速度和峰值
+        JoystickOptions options;
+        std::string trace_file;
+        double sample_rate = 0.0;
+        bool interpolate = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--gamecontroller")
+                options.game_controller = true;
+            else if (arg == "--mappings" && i + 1 < argc)
+                options.mappings_file = argv[++i];
+            else if (arg == "--sensors")
+                options.sensors = true;
+            else if (arg == "--orientation")
+                options.orientation = true;
+            else if (arg == "--filter" && i + 1 < argc)
+            {
+                std::string mode = argv[++i];
+                options.axis_filter.mode = mode == "off"      ? AxisFilterMode::OFF
+                                           : mode == "kalman" ? AxisFilterMode::KALMAN
+                                                              : AxisFilterMode::ONE_EURO;
+            }
+            else if (arg == "--virtual-output" && i + 1 < argc)
+                options.virtual_output = openVirtualGamepadSink(argv[++i]);
+            else if (arg == "--poll-interval" && i + 1 < argc)
+                options.poll_interval_ms = std::atoi(argv[++i]);
+            else if (arg == "--rt-cpu" && i + 1 < argc)
+                options.realtime.cpu = std::atoi(argv[++i]);
+            else if (arg == "--rt-priority" && i + 1 < argc)
+                options.realtime.priority = std::atoi(argv[++i]);
+            else if (arg == "--mlock")
+                options.realtime.lock_memory = true;
+            else if (arg == "--sample-rate" && i + 1 < argc)
+                sample_rate = std::atof(argv[++i]);
+            else if (arg == "--interpolate")
+                interpolate = true;
+            else if (arg == "--history" && i + 1 < argc)
+                options.axis_history_windows_ms.push_back(static_cast<uint32_t>(std::atoi(argv[++i])));
+            else if (arg == "--config" && i + 1 < argc)
+                options.config_file = argv[++i];
+            else if (arg == "--pipeline" && i + 1 < argc)
+                options.axis_pipeline = std::make_shared<DynamicAxisPipeline>(DynamicAxisPipeline::parse(argv[++i]));
+            else if (arg == "--keyboard-mouse")
+                options.keyboard_mouse = true;
+            else if (arg == "--trace" && i + 1 < argc)
+                trace_file = argv[++i];
+            else
+                std::cerr << "忽略未知参数: " << arg << std::endl;
+        }
+
         std::atomic_bool program_running{true};
-        SimpleJoystick joystick;
+        SimpleJoystick joystick(options);
+        FrameTracer &tracer = joystick.tracer();
+        tracer.nameThread("main");
+
+        // 定期导出指标, 可用 node_exporter textfile collector 采集
+        constexpr const char *METRICS_DUMP_PATH = "/tmp/simple_joystick.prom";
+        MetricsFileExporter metrics_exporter(joystick.metrics(), METRICS_DUMP_PATH, seconds(5));
+
+        // 按钮命令经调度器去抖、限速后在独立线程发送, 发送后短震一下作为确认
+        CommandScheduler commands([&joystick](int command)
+                                  {
+                                      const ButtonCommand *entry = findCommandById(command);
+                                      std::cout << "\n发送命令: " << command << " (" << (entry ? entry->label : "?") << ")" << std::endl;
+                                      joystick.rumble(0x4000, 0x4000, 80); },
+                                  joystick.metrics(), &tracer);
+        CommandPolicy policy;
+        policy.debounce = milliseconds(150);
+        policy.rate_per_sec = 4.0;
+        policy.burst = 2.0;
+        ActionMap actions;
+        // 配置文件有 [bindings] 时按它绑定, 否则用内置的按钮命令表; 配置重新加载后重建
+        auto bindActions = [&](const JoystickConfig *config)
+        {
+            actions.clear();
+            if (config && !config->bindings.empty())
+            {
+                for (const ConfigBinding &binding : config->bindings)
+                {
+                    commands.setPolicy(binding.command, policy);
+                    actions.bind(binding.source, binding.code, binding.command);
+                }
+                return;
+            }
+            for (const auto &entry : BUTTON_COMMANDS)
+            {
+                commands.setPolicy(entry.command, policy);
+                actions.bind(InputSource::JOYSTICK_BUTTON, entry.raw_button, entry.command);
+                actions.bind(InputSource::CONTROLLER_BUTTON, entry.standard_button, entry.command);
+                actions.bind(InputSource::KEY, entry.key, entry.command);
+            }
+            actions.bind(InputSource::MOUSE_BUTTON, 0, 1);
+        };
+        uint64_t config_generation = joystick.configGeneration();
+        bindActions(joystick.config().get());
+        uint64_t last_actions = 0;
+
+        // IMU 样本按批读取, 只显示最新的陀螺仪值
+        uint64_t imu_cursor = joystick.imuCursor();
+        std::vector<ImuSample> imu_batch(256);
+        ImuSample last_gyro = ImuSample();
+
+        // 指定采样频率时按绝对节拍读取, 否则每发布一帧读一次
+        std::unique_ptr<FixedRateSampler> sampler;
+        if (sample_rate > 0.0)
+            sampler.reset(new FixedRateSampler(joystick, sample_rate, interpolate));
+        FixedRateSample sample;
+        uint64_t frame_seq = 0;
 
         // 启动键盘监听线程
         std::thread kb_thread(keyboardListener, std::ref(program_running), std::ref(joystick));
 
         while (program_running)
         {
+            if (joystick.configGeneration() != config_generation)
+            {
+                config_generation = joystick.configGeneration();
+                bindActions(joystick.config().get());
+            }
+
+            // 打印连接状态变化
+            ConnectionEvent conn;
+            while (joystick.pollConnectionEvent(conn))
+            {
+                const char *state = conn.state == ConnectionState::CONNECTED  ? "已连接"
+                                    : conn.state == ConnectionState::FAILOVER ? "已切换到备用设备"
+                                                                              : "已断开";
+                std::cout << "\n摇杆" << state << " (ID: " << conn.instance_id << ")" << std::endl;
+            }
+
             if (joystick.isRunning())
             {
                 // 获取当前摇杆状态
-                auto data = joystick.getData();
+                if (sampler)
+                {
+                    sampler->next(sample);
+                }
+                else
+                {
+                    // 没有新帧时阻塞, 超时用于及时打印连接状态
+                    frame_seq = joystick.waitForChange(frame_seq, milliseconds(100));
+                }
+                // 超时醒来时数据没变, 读缓存不加锁也不拷贝
+                const JoystickData &data = sampler ? sample.data : joystick.getCachedData();
+                // 只追踪每个新帧的第一次显示
+                static uint64_t last_frame = 0;
+                TraceScope render(data.frame_id != last_frame ? &tracer : nullptr, "main_render", data.frame_id);
+                last_frame = data.frame_id;
 
                 // 打印轴状态
                 std::cout << "Axes: [";
@@ -295,40 +335,69 @@ int main()
                 {
                     std::cout << (pressed ? '1' : '0');
                 }
-                std::cout << "]        \r" << std::flush;
-                // 检测按钮状态变化并发送命令
-                static std::vector<bool> last_button_state = data.buttons; // 保存上一次按钮状态
+                std::cout << "]";
 
-                // 遍历所有按钮
-                for (int i = 0; i < data.buttons.size(); i++)
+                // 打印方向键和扳机
+                if (data.num_hats > 0)
                 {
-                    // 检测按钮按下事件
-                    if (data.buttons[i] && !last_button_state[i])
+                    std::cout << " Hats: [";
+                    for (std::size_t i = 0; i < data.num_hats; i++)
                     {
-                        // 根据新的按钮映射处理命令
-                        if (i == 0)
-                        { // X按钮 (第一位)
-                            std::cout << "\n发送命令: 3 (按钮X)" << std::endl;
-                        }
-                        else if (i == 1)
-                        { // A按钮 (第二位)
-                            std::cout << "\n发送命令: 1 (按钮A)" << std::endl;
-                        }
-                        else if (i == 2)
-                        { // B按钮 (第三位)
-                            std::cout << "\n发送命令: 2 (按钮B)" << std::endl;
-                        }
-                        else if (i == 3)
-                        { // Y按钮 (第四位)
-                            std::cout << "\n发送命令: 4 (按钮Y)" << std::endl;
-                        }
+                        printf("%X", data.hats[i]);
                     }
+                    std::cout << "]";
                 }
-
-                last_button_state = data.buttons; // 更新按钮状态
+                if (data.num_triggers > 0)
+                {
+                    std::cout << " Triggers: [";
+                    for (std::size_t i = 0; i < data.num_triggers; i++)
+                    {
+                        printf("%4.2f ", data.triggers[i]);
+                    }
+                    std::cout << "]";
+                }
+                std::size_t imu_count;
+                while ((imu_count = joystick.readImu(imu_cursor, imu_batch.data(), imu_batch.size())) > 0)
+                {
+                    for (std::size_t i = 0; i < imu_count; i++)
+                    {
+                        if (imu_batch[i].sensor == SDL_SENSOR_GYRO)
+                            last_gyro = imu_batch[i];
+                    }
+                }
+                if (joystick.imuSensors() & 2u)
+                {
+                    printf(" Gyro: [%6.2f %6.2f %6.2f]", last_gyro.data[0], last_gyro.data[1], last_gyro.data[2]);
+                }
+                AxisWindowStats stats[2];
+                if (joystick.axisStats(0, 0, stats[0]) && joystick.axisStats(1, 0, stats[1]))
+                {
+                    printf(" Vel: [%6.2f %6.2f] Peak: [%5.2f %5.2f]", stats[0].velocity, stats[1].velocity,
+                           std::max(stats[0].max, -stats[0].min), std::max(stats[1].max, -stats[1].min));
+                }
+                if (data.has_orientation)
+                {
+                    printf(" Quat: [%5.2f %5.2f %5.2f %5.2f]", data.orientation[0], data.orientation[1],
+                           data.orientation[2], data.orientation[3]);
+                }
+                std::cout << "        \r" << std::flush;
+                // 动作从未按下变为按下时交给调度器发送, 手柄和键鼠绑定到同一动作时只触发一次
+                uint64_t active = actions.evaluate(data);
+                for (uint64_t pressed = active & ~last_actions; pressed; pressed &= pressed - 1)
+                {
+                    commands.submit(__builtin_ctzll(pressed), data.frame_id);
+                }
+                last_actions = active;
+            }
+            else
+            {
+                // 暂停期间阻塞等待状态变化, 不再按 10ms 空转
+                joystick.waitWhilePaused(milliseconds(200));
+                // 暂停的时间不算错过节拍
+                if (sampler)
+                    sampler->reset();
+                continue;
             }
-
-            std::this_thread::sleep_for(milliseconds(10));
         }
 
         // 等待键盘线程结束
@@ -337,6 +406,14 @@ int main()
             kb_thread.join();
         }
 
+        if (!trace_file.empty())
+        {
+            if (tracer.exportChromeJson(trace_file))
+                std::cout << "\n追踪已导出: " << trace_file << std::endl;
+            else
+                std::cerr << "\n追踪导出失败: " << trace_file << std::endl;
+        }
+
         std::cout << "\n程序已安全退出" << std::endl;
     }
     catch (const std::exception &e)
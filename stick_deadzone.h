@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class DeadzoneShape : uint8_t
+{
+    // 每个轴单独截断 (方形), 斜向容易卡在轴上
+    AXIAL,
+    // 按摇杆偏移量截断, 出死区后保持原值 (幅度在死区边缘跳变)
+    RADIAL,
+    // 按偏移量截断并把 [inner, outer] 重新映射到 [anti_deadzone, 1], 幅度连续
+    SCALED_RADIAL,
+    // 在 SCALED_RADIAL 基础上, 靠近上下左右方向时把另一个轴吸附到 0 (十字形)
+    BOWTIE
+};
+
+// 一个摇杆的两个轴 (快照中的轴索引) 及其死区参数
+struct StickPairConfig
+{
+    int x_axis = 0;
+    int y_axis = 1;
+    DeadzoneShape shape = DeadzoneShape::SCALED_RADIAL;
+    float inner = 0.1f;         // 死区半径
+    float outer = 1.0f;         // 超过后输出饱和为 1
+    float anti_deadzone = 0.0f; // 离开死区后的最小输出, 抵消游戏自带的死区
+    float bowtie = 0.2f;        // BOWTIE 的吸附宽度: |x| < bowtie * |y| 时 x 归零
+};
+
+// 在帧发布时按摇杆对计算死区; 参数按对展开成结构数组,
+// 每对的计算都是无分支的同一串浮点运算, 编译器可以按对向量化
+// (GCC 需要 -fno-math-errno -fno-trapping-math, 见 CMakeLists.txt)
+class StickDeadzones
+{
+public:
+    // is_stick[axis] 为 false 的轴 (扳机等) 和越界的轴对被忽略
+    void configure(const std::vector<StickPairConfig> &pairs, const std::vector<bool> &is_stick)
+    {
+        x_.clear();
+        y_.clear();
+        inner_.clear();
+        outer_.clear();
+        inv_range_.clear();
+        anti_.clear();
+        scaled_.clear();
+        axial_.clear();
+        bowtie_.clear();
+        member_.assign(is_stick.size(), false);
+
+        for (const StickPairConfig &pair : pairs)
+        {
+            if (pair.x_axis < 0 || pair.y_axis < 0 || pair.x_axis == pair.y_axis ||
+                static_cast<std::size_t>(pair.x_axis) >= is_stick.size() ||
+                static_cast<std::size_t>(pair.y_axis) >= is_stick.size() ||
+                !is_stick[pair.x_axis] || !is_stick[pair.y_axis] ||
+                member_[pair.x_axis] || member_[pair.y_axis])
+                continue;
+
+            member_[pair.x_axis] = true;
+            member_[pair.y_axis] = true;
+            float outer = pair.outer > pair.inner + 1e-3f ? pair.outer : pair.inner + 1e-3f;
+            x_.push_back(pair.x_axis);
+            y_.push_back(pair.y_axis);
+            inner_.push_back(pair.inner);
+            outer_.push_back(outer);
+            inv_range_.push_back(1.0f / (outer - pair.inner));
+            anti_.push_back(pair.anti_deadzone);
+            scaled_.push_back(pair.shape == DeadzoneShape::SCALED_RADIAL || pair.shape == DeadzoneShape::BOWTIE ? 1.0f : 0.0f);
+            axial_.push_back(pair.shape == DeadzoneShape::AXIAL ? 1.0f : 0.0f);
+            bowtie_.push_back(pair.shape == DeadzoneShape::BOWTIE ? pair.bowtie : 0.0f);
+        }
+        px_.resize(x_.size());
+        py_.resize(x_.size());
+    }
+
+    // 该轴是否属于某个摇杆对 (不再单独应用轴死区)
+    bool contains(std::size_t axis) const
+    {
+        return axis < member_.size() && member_[axis];
+    }
+
+    // 从 in 读取各对的原始值, 把结果写入 out; in/out 按快照轴索引
+    void apply(const float *in, float *out)
+    {
+        const std::size_t n = x_.size();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            px_[i] = in[x_[i]];
+            py_[i] = in[y_[i]];
+        }
+        computePairs(n, inner_.data(), outer_.data(), inv_range_.data(), anti_.data(), scaled_.data(),
+                     axial_.data(), bowtie_.data(), px_.data(), py_.data());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[x_[i]] = px_[i];
+            out[y_[i]] = py_[i];
+        }
+    }
+
+    bool empty() const
+    {
+        return x_.empty();
+    }
+
+private:
+    // 各对原地计算; 参数数组互不重叠, 标成 __restrict 让编译器省掉别名检查直接向量化
+    static void computePairs(std::size_t n, const float *__restrict inner, const float *__restrict outer,
+                             const float *__restrict inv_range, const float *__restrict anti,
+                             const float *__restrict scaled, const float *__restrict axial,
+                             const float *__restrict bowtie, float *__restrict px, float *__restrict py)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            float x = px[i], y = py[i];
+            float mag = std::sqrt(x * x + y * y);
+            float active = mag > inner[i] ? 1.0f : 0.0f;
+            float clamped = mag < outer[i] ? mag : outer[i];
+            float t = anti[i] + (1.0f - anti[i]) * (clamped - inner[i]) * inv_range[i];
+            float scale = active * (scaled[i] * t / (mag > 1e-6f ? mag : 1e-6f) + (1.0f - scaled[i]));
+            float rx = x * scale, ry = y * scale;
+
+            // 十字形吸附: 另一个轴越大, 本轴的死区越宽; 吸附后恢复原幅度, 只改变方向
+            float ax = std::fabs(rx), ay = std::fabs(ry);
+            float wx = bowtie[i] * ay, wy = bowtie[i] * ax;
+            float bx = ax > wx ? ax - wx : 0.0f;
+            float by = ay > wy ? ay - wy : 0.0f;
+            float bmag = std::sqrt(bx * bx + by * by);
+            float restore = std::sqrt(ax * ax + ay * ay) / (bmag > 1e-6f ? bmag : 1e-6f);
+            rx = std::copysign(bx * restore, rx);
+            ry = std::copysign(by * restore, ry);
+
+            // AXIAL: 每个轴单独截断
+            float qx = std::fabs(x) > inner[i] ? x : 0.0f;
+            float qy = std::fabs(y) > inner[i] ? y : 0.0f;
+            rx = axial[i] * qx + (1.0f - axial[i]) * rx;
+            ry = axial[i] * qy + (1.0f - axial[i]) * ry;
+
+            px[i] = rx > 1.0f ? 1.0f : (rx < -1.0f ? -1.0f : rx);
+            py[i] = ry > 1.0f ? 1.0f : (ry < -1.0f ? -1.0f : ry);
+        }
+    }
+
+    std::vector<int> x_, y_;
+    std::vector<float> inner_, outer_, inv_range_, anti_, scaled_, axial_, bowtie_;
+    std::vector<float> px_, py_; // 按对收集的 x/y, 计算时原地改写
+    std::vector<bool> member_;
+};
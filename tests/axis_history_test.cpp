@@ -0,0 +1,181 @@
+// 轴历史: 时间窗口淘汰、容量截短, 以及与逐样本重新计算的结果对照
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "axis_history.h"
+#include "test_check.h"
+
+namespace
+{
+    struct Sample
+    {
+        uint32_t timestamp_ms;
+        float value;
+    };
+
+    // 直接按定义计算: 最近 capacity 个样本中未超出窗口的 (最新样本始终保留)
+    AxisWindowStats reference(const std::vector<Sample> &samples, uint32_t window_ms, std::size_t capacity,
+                              uint32_t now_ms)
+    {
+        AxisWindowStats stats;
+        if (samples.empty())
+            return stats;
+        std::size_t newest = samples.size() - 1;
+        std::size_t first = samples.size() > capacity ? samples.size() - capacity : 0;
+        while (first < newest && now_ms - samples[first].timestamp_ms > window_ms)
+            ++first;
+        double sum = 0.0;
+        stats.min = stats.max = samples[first].value;
+        for (std::size_t i = first; i <= newest; ++i)
+        {
+            stats.min = std::min(stats.min, samples[i].value);
+            stats.max = std::max(stats.max, samples[i].value);
+            sum += samples[i].value;
+        }
+        stats.samples = static_cast<uint32_t>(newest - first + 1);
+        stats.avg = static_cast<float>(sum / stats.samples);
+        uint32_t dt_ms = samples[newest].timestamp_ms - samples[first].timestamp_ms;
+        if (dt_ms)
+            stats.velocity = (samples[newest].value - samples[first].value) * 1000.0f / dt_ms;
+        return stats;
+    }
+
+    void checkStats(const AxisWindowStats &actual, const AxisWindowStats &expected)
+    {
+        CHECK(actual.samples == expected.samples);
+        CHECK(actual.min == expected.min);
+        CHECK(actual.max == expected.max);
+        CHECK_NEAR(actual.avg, expected.avg, 1e-4f);
+        CHECK_NEAR(actual.velocity, expected.velocity, 1e-3f * std::max(1.0f, std::fabs(expected.velocity)));
+    }
+
+    void testTimeEviction()
+    {
+        AxisHistory history(std::vector<uint32_t>{100});
+        history.reset(1);
+        history.record(0, 1000, 1.0f);
+        history.record(0, 1050, -1.0f);
+        history.record(0, 1080, 0.5f);
+        history.publish(1090);
+        AxisWindowStats stats;
+        CHECK(history.query(0, 0, stats));
+        CHECK(stats.samples == 3);
+        CHECK(stats.min == -1.0f && stats.max == 1.0f);
+        CHECK_NEAR(stats.avg, 0.5f / 3.0f, 1e-6f);
+        CHECK_NEAR(stats.velocity, -0.5f * 1000.0f / 80.0f, 1e-3f);
+
+        // 1000 的样本超出窗口, 峰值随之移出
+        history.publish(1120);
+        CHECK(history.query(0, 0, stats));
+        CHECK(stats.samples == 2);
+        CHECK(stats.min == -1.0f && stats.max == 0.5f);
+
+        // 长时间没有事件: 只剩轴当前保持的值
+        history.publish(5000);
+        CHECK(history.query(0, 0, stats));
+        CHECK(stats.samples == 1);
+        CHECK(stats.min == 0.5f && stats.max == 0.5f && stats.avg == 0.5f && stats.velocity == 0.0f);
+
+        // 新样本进来时保持的旧值也超出窗口
+        history.record(0, 5001, -0.25f);
+        history.publish(5001);
+        CHECK(history.query(0, 0, stats));
+        CHECK(stats.samples == 1);
+        CHECK(stats.min == -0.25f && stats.max == -0.25f);
+    }
+
+    void testCapacityTruncation()
+    {
+        const std::size_t CAPACITY = 8;
+        AxisHistory history(std::vector<uint32_t>{100000}, CAPACITY);
+        history.reset(1);
+        // 峰值先出现, 之后被挤出容量; 滑动和与单调队列都不能残留被覆盖的槽位
+        for (int i = 0; i < 40; ++i)
+        {
+            float value = i == 0 ? 10.0f : static_cast<float>(i % 5) * 0.1f;
+            history.record(0, 100 + i, value);
+        }
+        history.publish(140);
+        AxisWindowStats stats;
+        CHECK(history.query(0, 0, stats));
+        CHECK(stats.samples == CAPACITY);
+        CHECK(stats.max == 0.4f);
+        CHECK(stats.min == 0.0f);
+        float sum = 0.0f;
+        for (int i = 32; i < 40; ++i)
+            sum += static_cast<float>(i % 5) * 0.1f;
+        CHECK_NEAR(stats.avg, sum / CAPACITY, 1e-5f);
+    }
+
+    void testQueryBounds()
+    {
+        AxisHistory history(std::vector<uint32_t>{50, 500});
+        AxisWindowStats stats;
+        CHECK(!history.query(0, 0, stats));
+        history.reset(2);
+        history.publish(0);
+        CHECK(history.query(1, 1, stats));
+        CHECK(stats.samples == 0);
+        CHECK(!history.query(2, 0, stats));
+        CHECK(!history.query(0, 2, stats));
+        CHECK(!history.query(AxisHistory::MAX_AXES, 0, stats));
+        CHECK(history.windowCount() == 2 && history.windowMs(1) == 500 && history.windowMs(2) == 0);
+
+        // 轴数变化后旧的轴不再可读
+        history.reset(1);
+        history.publish(10);
+        CHECK(history.query(0, 0, stats));
+        CHECK(!history.query(1, 0, stats));
+    }
+
+    // 随机时间间隔 (包括同一毫秒) 和随机轴, 每次发布后与逐样本计算对照
+    void testAgainstReference()
+    {
+        const std::size_t CAPACITY = 64;
+        const std::size_t AXES = 3;
+        const std::vector<uint32_t> windows = {20, 150, 1000};
+        AxisHistory history(windows, CAPACITY);
+        history.reset(AXES);
+        std::vector<std::vector<Sample>> samples(AXES);
+
+        std::srand(12345);
+        uint32_t now_ms = 0xFFFFF000u; // 跨过 32 位回绕
+        for (int step = 0; step < 20000; ++step)
+        {
+            now_ms += static_cast<uint32_t>(std::rand() % 4 == 0 ? std::rand() % 40 : 0);
+            int events = std::rand() % 6;
+            for (int e = 0; e < events; ++e)
+            {
+                std::size_t axis = static_cast<std::size_t>(std::rand()) % AXES;
+                Sample sample;
+                sample.timestamp_ms = now_ms;
+                sample.value = static_cast<float>(std::rand() % 2001 - 1000) / 1000.0f;
+                history.record(axis, sample.timestamp_ms, sample.value);
+                samples[axis].push_back(sample);
+            }
+            history.publish(now_ms);
+            for (std::size_t axis = 0; axis < AXES; ++axis)
+            {
+                for (std::size_t w = 0; w < windows.size(); ++w)
+                {
+                    AxisWindowStats stats;
+                    CHECK(history.query(axis, w, stats));
+                    checkStats(stats, reference(samples[axis], windows[w], CAPACITY, now_ms));
+                }
+            }
+            if (test_check::failures())
+                return;
+        }
+    }
+}
+
+int main()
+{
+    testTimeEviction();
+    testCapacityTruncation();
+    testQueryBounds();
+    testAgainstReference();
+    if (test_check::failures())
+        std::fprintf(stderr, "%d check(s) failed\n", test_check::failures());
+    return test_check::failures() ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+// 命令限速: 令牌桶的补充与截断用固定时钟验证, 以及 setPolicy 的参数检查
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include "command_scheduler.h"
+#include "test_check.h"
+
+namespace
+{
+    typedef TokenBucket::Clock Clock;
+
+    Clock::time_point at(int ms)
+    {
+        return Clock::time_point(std::chrono::milliseconds(ms));
+    }
+
+    void testRefill()
+    {
+        TokenBucket bucket(4.0, 2.0, at(1000));
+        CHECK(bucket.tokens(at(1000)) == 2.0);
+        CHECK(bucket.take(at(1000)));
+        CHECK(bucket.take(at(1000)));
+        CHECK(!bucket.take(at(1000)));
+        CHECK(bucket.nextToken(at(1000)) == at(1250));
+
+        // 每秒 4 个: 125ms 补半个, 250ms 补满一个
+        CHECK_NEAR(bucket.tokens(at(1125)), 0.5, 1e-9);
+        CHECK(!bucket.take(at(1125)));
+        CHECK(bucket.take(at(1250)));
+        CHECK_NEAR(bucket.tokens(at(1250)), 0.0, 1e-9);
+
+        // 补充不超过容量
+        CHECK(bucket.tokens(at(10000)) == 2.0);
+
+        // 时钟不会倒退, 早于上次补充的时间不扣令牌
+        CHECK(bucket.tokens(at(5000)) == 2.0);
+    }
+
+    void testUnlimited()
+    {
+        TokenBucket bucket(0.0, 1.0, at(0));
+        for (int i = 0; i < 100; ++i)
+            CHECK(bucket.take(at(0)));
+    }
+
+    void testConfigureKeepsTokens()
+    {
+        TokenBucket bucket(4.0, 4.0, at(0));
+        CHECK(bucket.take(at(0)));
+        CHECK(bucket.take(at(0)));
+        CHECK(bucket.take(at(0)));
+
+        // 重新设置同样的策略: 剩余的 1 个令牌不会被补满
+        bucket.configure(4.0, 4.0, at(0));
+        CHECK(bucket.tokens(at(0)) == 1.0);
+
+        // 容量变小时截断到新容量
+        bucket.configure(4.0, 4.0, at(1000));
+        CHECK(bucket.tokens(at(1000)) == 4.0);
+        bucket.configure(4.0, 2.0, at(1000));
+        CHECK(bucket.tokens(at(1000)) == 2.0);
+
+        // 变更前按旧速率补到变更时刻, 之后按新速率补充
+        CHECK(bucket.take(at(1000)));
+        CHECK(bucket.take(at(1000)));
+        bucket.configure(1.0, 2.0, at(1125));
+        CHECK_NEAR(bucket.tokens(at(1125)), 0.5, 1e-9);
+        CHECK_NEAR(bucket.tokens(at(1625)), 1.0, 1e-9);
+    }
+
+    bool rejects(double rate_per_sec, double burst)
+    {
+        MetricsRegistry registry;
+        CommandScheduler scheduler([](int) {}, registry);
+        CommandPolicy policy;
+        policy.rate_per_sec = rate_per_sec;
+        policy.burst = burst;
+        try
+        {
+            scheduler.setPolicy(1, policy);
+        }
+        catch (const std::runtime_error &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    void testPolicyValidation()
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+        CHECK(!rejects(4.0, 2.0));
+        CHECK(!rejects(0.0, 1.0));
+        CHECK(rejects(4.0, 0.5));
+        CHECK(rejects(4.0, 0.0));
+        CHECK(rejects(4.0, nan));
+        CHECK(rejects(4.0, inf));
+        CHECK(rejects(nan, 2.0));
+        CHECK(rejects(inf, 2.0));
+        CHECK(rejects(-1.0, 2.0));
+    }
+}
+
+int main()
+{
+    testRefill();
+    testUnlimited();
+    testConfigureKeepsTokens();
+    testPolicyValidation();
+    if (test_check::failures())
+        std::fprintf(stderr, "%d check(s) failed\n", test_check::failures());
+    return test_check::failures() ? 1 : 0;
+}
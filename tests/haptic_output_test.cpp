@@ -0,0 +1,114 @@
+// 震动/LED 输出: 邮箱合并语义, 以及没有设备时请求经事件线程送到后端
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "joystick_core.h"
+#include "test_check.h"
+
+using namespace std::chrono;
+
+namespace
+{
+    void testMailboxCoalesces()
+    {
+        HapticMailbox mailbox;
+        CHECK(!mailbox.pending());
+        CHECK(!mailbox.post(HapticMailbox::RUMBLE, HapticMailbox::packRumble(1, 2, 3)));
+        CHECK(mailbox.post(HapticMailbox::RUMBLE, HapticMailbox::packRumble(4, 5, 6)));
+        CHECK(!mailbox.post(HapticMailbox::LED, HapticMailbox::packLed(7, 8, 9)));
+        CHECK(mailbox.pending());
+
+        uint32_t dirty = mailbox.take();
+        CHECK(dirty == ((1u << HapticMailbox::RUMBLE) | (1u << HapticMailbox::LED)));
+        CHECK(!mailbox.pending());
+        CHECK(mailbox.value(HapticMailbox::RUMBLE) == HapticMailbox::packRumble(4, 5, 6));
+
+        mailbox.repost(HapticMailbox::LED);
+        CHECK(mailbox.take() == (1u << HapticMailbox::LED));
+        CHECK(mailbox.value(HapticMailbox::LED) == HapticMailbox::packLed(7, 8, 9));
+    }
+
+    // 等到后端记录的调用满足条件, 最多 2 秒
+    template <typename Predicate>
+    bool waitForCalls(const RecordingHapticBackend &backend, Predicate done)
+    {
+        steady_clock::time_point deadline = steady_clock::now() + seconds(2);
+        while (steady_clock::now() < deadline)
+        {
+            if (done(backend.calls()))
+                return true;
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return false;
+    }
+
+    const RecordingHapticBackend::Call *lastCall(const std::vector<RecordingHapticBackend::Call> &calls,
+                                                 RecordingHapticBackend::Kind kind)
+    {
+        for (std::size_t i = calls.size(); i-- > 0;)
+        {
+            if (calls[i].kind == kind)
+                return &calls[i];
+        }
+        return nullptr;
+    }
+
+    void testRequestsReachBackend()
+    {
+        std::shared_ptr<RecordingHapticBackend> backend = std::make_shared<RecordingHapticBackend>();
+        JoystickOptions options;
+        options.haptic_backend = backend;
+        options.poll_interval_ms = 5;
+        SimpleJoystick joystick(options);
+
+        joystick.setLed(10, 20, 30);
+        joystick.rumble(100, 200, 300);
+        joystick.rumbleTriggers(5, 6, 7);
+        CHECK(waitForCalls(*backend, [](const std::vector<RecordingHapticBackend::Call> &calls)
+                           { return lastCall(calls, RecordingHapticBackend::LED) &&
+                                    lastCall(calls, RecordingHapticBackend::RUMBLE) &&
+                                    lastCall(calls, RecordingHapticBackend::RUMBLE_TRIGGERS); }));
+        std::vector<RecordingHapticBackend::Call> calls = backend->calls();
+        const RecordingHapticBackend::Call *led = lastCall(calls, RecordingHapticBackend::LED);
+        const RecordingHapticBackend::Call *rumble = lastCall(calls, RecordingHapticBackend::RUMBLE);
+        const RecordingHapticBackend::Call *triggers = lastCall(calls, RecordingHapticBackend::RUMBLE_TRIGGERS);
+        CHECK(led && led->a == 10 && led->b == 20 && led->duration_ms == 30);
+        CHECK(rumble && rumble->a == 100 && rumble->b == 200 && rumble->duration_ms == 300);
+        CHECK(triggers && triggers->a == 5 && triggers->b == 6 && triggers->duration_ms == 7);
+
+        // 连续请求: 下发的调用不多于请求, 顺序不乱, 最后一次一定送达
+        std::size_t before = backend->calls().size();
+        const int BURST = 1000;
+        for (int i = 1; i <= BURST; ++i)
+            joystick.rumble(static_cast<uint16_t>(i), 0, 50);
+        CHECK(waitForCalls(*backend, [](const std::vector<RecordingHapticBackend::Call> &calls)
+                           { const RecordingHapticBackend::Call *call = lastCall(calls, RecordingHapticBackend::RUMBLE);
+                             return call && call->a == BURST; }));
+        calls = backend->calls();
+        CHECK(calls.size() - before <= static_cast<std::size_t>(BURST));
+        uint16_t previous = 0;
+        for (std::size_t i = before; i < calls.size(); ++i)
+        {
+            CHECK(calls[i].kind == RecordingHapticBackend::RUMBLE);
+            CHECK(calls[i].a > previous);
+            previous = calls[i].a;
+        }
+
+        // 暂停时输出照常下发
+        CHECK(joystick.pause());
+        CHECK(joystick.waitWhilePaused(milliseconds(0)) != AcquisitionState::STOPPED);
+        joystick.setLed(1, 2, 3);
+        CHECK(waitForCalls(*backend, [](const std::vector<RecordingHapticBackend::Call> &calls)
+                           { const RecordingHapticBackend::Call *call = lastCall(calls, RecordingHapticBackend::LED);
+                             return call && call->a == 1 && call->b == 2 && call->duration_ms == 3; }));
+    }
+}
+
+int main()
+{
+    testMailboxCoalesces();
+    testRequestsReachBackend();
+    if (test_check::failures())
+        std::fprintf(stderr, "%d check(s) failed\n", test_check::failures());
+    return test_check::failures() ? 1 : 0;
+}
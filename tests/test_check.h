@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdio>
+
+// 测试用的最小断言: 失败时打印位置并计数, main 返回失败个数
+namespace test_check
+{
+    inline int &failures()
+    {
+        static int count = 0;
+        return count;
+    }
+}
+
+#define CHECK(condition)                                                                     \
+    do                                                                                       \
+    {                                                                                        \
+        if (!(condition))                                                                    \
+        {                                                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++test_check::failures();                                                        \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(((a) > (b) ? (a) - (b) : (b) - (a)) <= (tolerance))
@@ -0,0 +1,138 @@
+// 虚拟手柄输出: stage()/flush() 经 FileOutputSink 写入文件, 读回后逐条核对事件
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "test_check.h"
+#include "virtual_gamepad.h"
+
+namespace
+{
+    using namespace virtual_gamepad_detail;
+
+    const char *const OUTPUT_PATH = "virtual_gamepad_test.events";
+
+    // VirtualGamepad::stage() 需要的快照字段
+    struct Frame
+    {
+        bool standard_layout = true;
+        std::vector<float> axes = std::vector<float>(6, 0.0f);
+        std::array<float, 4> triggers = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        uint8_t num_triggers = 2;
+        std::array<uint8_t, 4> hats = {{0, 0, 0, 0}};
+        uint8_t num_hats = 1;
+        std::vector<bool> buttons = std::vector<bool>(21, false);
+    };
+
+    std::vector<VirtualEvent> readBack()
+    {
+        std::vector<VirtualEvent> events;
+        std::ifstream in(OUTPUT_PATH, std::ios::binary);
+        VirtualEvent event;
+        while (in.read(reinterpret_cast<char *>(&event), sizeof(event)))
+            events.push_back(event);
+        return events;
+    }
+
+    void checkEvent(const std::vector<VirtualEvent> &events, std::size_t index, uint16_t type, uint16_t code,
+                    int32_t value)
+    {
+        CHECK(index < events.size());
+        if (index >= events.size())
+            return;
+        CHECK(events[index].type == type);
+        CHECK(events[index].code == code);
+        CHECK(events[index].value == value);
+    }
+
+    void testFrames()
+    {
+        static_assert(sizeof(VirtualEvent) == 8, "file records are 8 bytes");
+        VirtualGamepad pad;
+        std::size_t written = 0;
+        {
+            FileOutputSink sink(OUTPUT_PATH);
+            CHECK(sink.ok());
+
+            // 第一帧: 轴、扳机、方向键 (上+右) 和两个按钮, 第 16 个按钮顺延到扩展按钮
+            Frame frame;
+            frame.axes[0] = 1.0f;
+            frame.axes[1] = -0.5f;
+            frame.axes[4] = 0.75f; // 标准布局下扳机轴不作为摇杆轴输出
+            frame.triggers[0] = 1.0f;
+            frame.hats[0] = 1 | 2;
+            frame.buttons[0] = true;
+            frame.buttons[16] = true;
+            CHECK(pad.stage(frame) == 7);
+            CHECK(pad.flush(sink));
+            written += 8;
+
+            // 没有变化: 不写
+            CHECK(pad.stage(frame) == 0);
+            CHECK(pad.flush(sink));
+
+            // 只输出变化的值
+            frame.axes[0] = 0.0f;
+            frame.buttons[0] = false;
+            CHECK(pad.stage(frame) == 2);
+            CHECK(pad.flush(sink));
+            written += 3;
+
+            // 切换到原始布局: 按钮全部改用扩展编码, 之前按下的一并释放
+            frame.standard_layout = false;
+            frame.buttons.assign(21, false);
+            frame.buttons[2] = true;
+            frame.axes[4] = 0.0f;
+            CHECK(pad.stage(frame) == 2);
+            CHECK(pad.staged() == 2);
+            CHECK(pad.flush(sink));
+            CHECK(pad.staged() == 0);
+            written += 3;
+        }
+
+        std::vector<VirtualEvent> events = readBack();
+        CHECK(events.size() == written);
+        checkEvent(events, 0, EV_ABS_TYPE, 0x00, AXIS_MAX);
+        checkEvent(events, 1, EV_ABS_TYPE, 0x01, -16384);
+        checkEvent(events, 2, EV_ABS_TYPE, 0x02, TRIGGER_MAX);
+        checkEvent(events, 3, EV_ABS_TYPE, HAT_X, 1);
+        checkEvent(events, 4, EV_ABS_TYPE, HAT_Y, -1);
+        checkEvent(events, 5, EV_KEY_TYPE, 0x130, 1);
+        checkEvent(events, 6, EV_KEY_TYPE, EXTRA_BUTTON_BASE + 1, 1);
+        checkEvent(events, 7, EV_SYN_TYPE, SYN_REPORT_CODE, 0);
+
+        checkEvent(events, 8, EV_ABS_TYPE, 0x00, 0);
+        checkEvent(events, 9, EV_KEY_TYPE, 0x130, 0);
+        checkEvent(events, 10, EV_SYN_TYPE, SYN_REPORT_CODE, 0);
+
+        // 标准布局的第 16 个按钮 (扩展按钮 1) 释放, 原始布局的第 2 个按钮是扩展按钮 2
+        checkEvent(events, 11, EV_KEY_TYPE, EXTRA_BUTTON_BASE + 1, 0);
+        checkEvent(events, 12, EV_KEY_TYPE, EXTRA_BUTTON_BASE + 2, 1);
+        checkEvent(events, 13, EV_SYN_TYPE, SYN_REPORT_CODE, 0);
+    }
+
+    // reset() 之后下一帧重新输出全部非零值
+    void testReset()
+    {
+        VirtualGamepad pad;
+        Frame frame;
+        frame.axes[2] = -1.0f;
+        frame.buttons[3] = true;
+        CHECK(pad.stage(frame) == 2);
+        CHECK(pad.stage(frame) == 0);
+        pad.reset();
+        CHECK(pad.staged() == 0);
+        CHECK(pad.stage(frame) == 2);
+    }
+}
+
+int main()
+{
+    testFrames();
+    testReset();
+    std::remove(OUTPUT_PATH);
+    if (test_check::failures())
+        std::fprintf(stderr, "%d check(s) failed\n", test_check::failures());
+    return test_check::failures() ? 1 : 0;
+}
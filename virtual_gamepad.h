@@ -0,0 +1,349 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// 虚拟设备的一条输出事件, 字段含义同 linux input_event (不含时间, 由内核填写)
+struct VirtualEvent
+{
+    uint16_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+// 绝对轴的取值范围
+struct VirtualAbsInfo
+{
+    uint16_t code;
+    int32_t min;
+    int32_t max;
+};
+
+// 虚拟设备输出端; 只在事件线程上调用
+class VirtualOutputSink
+{
+public:
+    virtual ~VirtualOutputSink() {}
+    // 一帧的全部事件 (末尾已带 SYN_REPORT), 实现应一次写出
+    virtual bool write(const VirtualEvent *events, std::size_t count) = 0;
+};
+
+namespace virtual_gamepad_detail
+{
+    // linux/input-event-codes.h 中的编码, 写成常量以便在非 Linux 上也能编译 FileOutputSink
+    constexpr uint16_t EV_SYN_TYPE = 0x00, EV_KEY_TYPE = 0x01, EV_ABS_TYPE = 0x03;
+    constexpr uint16_t SYN_REPORT_CODE = 0;
+    // ABS_X ABS_Y ABS_RX ABS_RY ABS_THROTTLE ABS_RUDDER ABS_WHEEL ABS_GAS
+    constexpr uint16_t AXIS_CODES[] = {0x00, 0x01, 0x03, 0x04, 0x06, 0x07, 0x08, 0x09};
+    // 扳机: ABS_Z ABS_RZ; 方向键: ABS_HAT0X ABS_HAT0Y
+    constexpr uint16_t TRIGGER_CODES[] = {0x02, 0x05};
+    constexpr uint16_t HAT_X = 0x10, HAT_Y = 0x11;
+    // 标准布局按钮, 顺序同 SDL_GameControllerButton:
+    // SOUTH EAST WEST NORTH SELECT MODE START THUMBL THUMBR TL TR DPAD_UP DPAD_DOWN DPAD_LEFT DPAD_RIGHT
+    constexpr uint16_t STANDARD_BUTTON_CODES[] = {0x130, 0x131, 0x134, 0x133, 0x13a, 0x13c, 0x13b, 0x13d,
+                                                  0x13e, 0x136, 0x137, 0x220, 0x221, 0x222, 0x223};
+    // 原始布局的按钮和标准布局多出的按钮 (MISC1、背键等) 用 BTN_TRIGGER_HAPPY1..40
+    constexpr uint16_t EXTRA_BUTTON_BASE = 0x2c0;
+    constexpr std::size_t EXTRA_BUTTON_COUNT = 40;
+    constexpr int32_t AXIS_MAX = 32767;
+    constexpr int32_t TRIGGER_MAX = 255;
+}
+
+// 把发布的快照编码成标准 Linux 手柄事件: 和上一帧比较, 只输出变化的值, 每帧一次写出
+// 设备能力固定 (8 轴、2 扳机、1 个方向键、15 个标准按钮加 40 个扩展按钮), 切换手柄不需要重建设备
+class VirtualGamepad
+{
+public:
+    static const char *name()
+    {
+        return "simple_joystick virtual gamepad";
+    }
+
+    VirtualGamepad()
+    {
+        events_.reserve(128);
+        reset();
+    }
+
+    // 设备声明的按钮编码
+    static std::vector<uint16_t> keyCodes()
+    {
+        using namespace virtual_gamepad_detail;
+        std::vector<uint16_t> codes(std::begin(STANDARD_BUTTON_CODES), std::end(STANDARD_BUTTON_CODES));
+        for (std::size_t i = 0; i < EXTRA_BUTTON_COUNT; ++i)
+            codes.push_back(static_cast<uint16_t>(EXTRA_BUTTON_BASE + i));
+        return codes;
+    }
+
+    // 设备声明的绝对轴
+    static std::vector<VirtualAbsInfo> absInfo()
+    {
+        using namespace virtual_gamepad_detail;
+        std::vector<VirtualAbsInfo> info;
+        for (uint16_t code : AXIS_CODES)
+            info.push_back(VirtualAbsInfo{code, -AXIS_MAX, AXIS_MAX});
+        for (uint16_t code : TRIGGER_CODES)
+            info.push_back(VirtualAbsInfo{code, 0, TRIGGER_MAX});
+        info.push_back(VirtualAbsInfo{HAT_X, -1, 1});
+        info.push_back(VirtualAbsInfo{HAT_Y, -1, 1});
+        return info;
+    }
+
+    // 下一帧输出全部非零值 (设备刚创建或输出端替换后)
+    void reset()
+    {
+        abs_.fill(0);
+        keys_.assign(KEY_SLOTS, false);
+        events_.clear();
+    }
+
+    // 在持有快照锁时调用, 只做比较和编码, 不做系统调用; 返回本帧变化的值数
+    // 标准布局下只输出摇杆轴 0-3, 扳机轴 (4/5) 由 triggers 输出
+    template <typename Frame>
+    std::size_t stage(const Frame &frame)
+    {
+        using namespace virtual_gamepad_detail;
+        events_.clear();
+
+        std::size_t num_axes = frame.standard_layout ? 4 : sizeof(AXIS_CODES) / sizeof(AXIS_CODES[0]);
+        for (std::size_t i = 0; i < num_axes; ++i)
+        {
+            float value = i < frame.axes.size() ? frame.axes[i] : 0.0f;
+            setAbs(AXIS_CODES[i], scale(value, AXIS_MAX));
+        }
+        for (std::size_t i = 0; i < sizeof(TRIGGER_CODES) / sizeof(TRIGGER_CODES[0]); ++i)
+        {
+            float value = i < frame.num_triggers ? frame.triggers[i] : 0.0f;
+            setAbs(TRIGGER_CODES[i], scale(value, TRIGGER_MAX));
+        }
+        // SDL_HAT_UP=1 RIGHT=2 DOWN=4 LEFT=8, 向下和向右为正
+        uint8_t hat = frame.num_hats > 0 ? frame.hats[0] : 0;
+        setAbs(HAT_X, ((hat >> 1) & 1) - ((hat >> 3) & 1));
+        setAbs(HAT_Y, ((hat >> 2) & 1) - (hat & 1));
+
+        // 布局切换时上一布局按下的按钮在这里一并释放
+        std::vector<bool> &want = scratch_keys_;
+        want.assign(KEY_SLOTS, false);
+        for (std::size_t i = 0; i < frame.buttons.size(); ++i)
+        {
+            if (!frame.buttons[i])
+                continue;
+            int slot = buttonSlot(i, frame.standard_layout);
+            if (slot >= 0)
+                want[slot] = true;
+        }
+        for (std::size_t slot = 0; slot < KEY_SLOTS; ++slot)
+        {
+            if (want[slot] != keys_[slot])
+            {
+                keys_[slot] = want[slot];
+                events_.push_back(VirtualEvent{EV_KEY_TYPE, slotCode(slot), want[slot] ? 1 : 0});
+            }
+        }
+        return events_.size();
+    }
+
+    // 把 stage() 编码的事件加上 SYN_REPORT 一次写出; 没有变化时不写
+    bool flush(VirtualOutputSink &sink)
+    {
+        using namespace virtual_gamepad_detail;
+        if (events_.empty())
+            return true;
+        events_.push_back(VirtualEvent{EV_SYN_TYPE, SYN_REPORT_CODE, 0});
+        bool ok = sink.write(events_.data(), events_.size());
+        events_.clear();
+        return ok;
+    }
+
+    // stage() 之后、flush() 之前的事件数
+    std::size_t staged() const
+    {
+        return events_.size();
+    }
+
+private:
+    static constexpr std::size_t STANDARD_SLOTS = sizeof(virtual_gamepad_detail::STANDARD_BUTTON_CODES) /
+                                                  sizeof(virtual_gamepad_detail::STANDARD_BUTTON_CODES[0]);
+    static constexpr std::size_t KEY_SLOTS = STANDARD_SLOTS + virtual_gamepad_detail::EXTRA_BUTTON_COUNT;
+
+    static int32_t scale(float value, int32_t max)
+    {
+        if (value > 1.0f)
+            value = 1.0f;
+        if (value < -1.0f)
+            value = -1.0f;
+        return static_cast<int32_t>(std::lround(value * static_cast<float>(max)));
+    }
+
+    // 标准布局: 前 15 个按钮用手柄按钮编码, 其余顺延到扩展按钮; 原始布局全部用扩展按钮
+    static int buttonSlot(std::size_t button, bool standard)
+    {
+        std::size_t slot = standard ? button : STANDARD_SLOTS + button;
+        return slot < KEY_SLOTS ? static_cast<int>(slot) : -1;
+    }
+
+    static uint16_t slotCode(std::size_t slot)
+    {
+        using namespace virtual_gamepad_detail;
+        return slot < STANDARD_SLOTS ? STANDARD_BUTTON_CODES[slot]
+                                     : static_cast<uint16_t>(EXTRA_BUTTON_BASE + (slot - STANDARD_SLOTS));
+    }
+
+    void setAbs(uint16_t code, int32_t value)
+    {
+        if (abs_[code] == value)
+            return;
+        abs_[code] = value;
+        events_.push_back(VirtualEvent{virtual_gamepad_detail::EV_ABS_TYPE, code, value});
+    }
+
+    std::array<int32_t, 0x40> abs_; // 按 ABS_* 编码
+    std::vector<bool> keys_;        // 按按钮槽位
+    std::vector<bool> scratch_keys_;
+    std::vector<VirtualEvent> events_;
+};
+
+#ifdef __linux__
+// 通过 /dev/uinput 创建内核输入设备, 其他程序像读真实手柄一样读取 (需要 /dev/uinput 写权限)
+class UinputSink : public VirtualOutputSink
+{
+public:
+    UinputSink(const char *name, const std::vector<uint16_t> &keys, const std::vector<VirtualAbsInfo> &abs)
+    {
+        fd_ = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd_ < 0)
+        {
+            error_ = "/dev/uinput: " + std::string(std::strerror(errno));
+            return;
+        }
+
+        uinput_user_dev dev = uinput_user_dev();
+        std::snprintf(dev.name, sizeof(dev.name), "%s", name);
+        dev.id.bustype = BUS_VIRTUAL;
+        dev.id.vendor = 0x1209; // pid.codes 开源项目共用的 vendor id
+        dev.id.product = 0x0001;
+        dev.id.version = 1;
+
+        bool ok = ioctl(fd_, UI_SET_EVBIT, EV_KEY) == 0 && ioctl(fd_, UI_SET_EVBIT, EV_ABS) == 0;
+        for (std::size_t i = 0; ok && i < keys.size(); ++i)
+            ok = ioctl(fd_, UI_SET_KEYBIT, keys[i]) == 0;
+        for (std::size_t i = 0; ok && i < abs.size(); ++i)
+        {
+            ok = ioctl(fd_, UI_SET_ABSBIT, abs[i].code) == 0;
+            dev.absmin[abs[i].code] = abs[i].min;
+            dev.absmax[abs[i].code] = abs[i].max;
+        }
+        ok = ok && ::write(fd_, &dev, sizeof(dev)) == static_cast<ssize_t>(sizeof(dev)) &&
+             ioctl(fd_, UI_DEV_CREATE) == 0;
+        if (!ok)
+        {
+            error_ = "uinput setup: " + std::string(std::strerror(errno));
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    ~UinputSink()
+    {
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, UI_DEV_DESTROY);
+            ::close(fd_);
+        }
+    }
+
+    bool ok() const
+    {
+        return fd_ >= 0;
+    }
+
+    const std::string &error() const
+    {
+        return error_;
+    }
+
+    // 非阻塞写, 读者跟不上时内核返回 EAGAIN, 本帧丢弃 (下一帧的变化照常输出)
+    bool write(const VirtualEvent *events, std::size_t count) override
+    {
+        buffer_.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buffer_[i] = input_event();
+            buffer_[i].type = events[i].type;
+            buffer_[i].code = events[i].code;
+            buffer_[i].value = events[i].value;
+        }
+        ssize_t bytes = static_cast<ssize_t>(count * sizeof(input_event));
+        return ::write(fd_, buffer_.data(), static_cast<std::size_t>(bytes)) == bytes;
+    }
+
+private:
+    UinputSink(const UinputSink &);
+    UinputSink &operator=(const UinputSink &);
+
+    int fd_ = -1;
+    std::string error_;
+    std::vector<input_event> buffer_;
+};
+#endif
+
+// 没有 /dev/uinput 时的替代输出: 每个事件按 VirtualEvent 的 8 字节原样写入文件
+class FileOutputSink : public VirtualOutputSink
+{
+public:
+    explicit FileOutputSink(const std::string &path)
+        : out_(path.c_str(), std::ios::binary | std::ios::trunc)
+    {
+    }
+
+    bool ok() const
+    {
+        return static_cast<bool>(out_);
+    }
+
+    bool write(const VirtualEvent *events, std::size_t count) override
+    {
+        out_.write(reinterpret_cast<const char *>(events), static_cast<std::streamsize>(count * sizeof(VirtualEvent)));
+        out_.flush(); // 与 uinput 一样每帧一次系统调用, 读者可以边写边读
+        return static_cast<bool>(out_);
+    }
+
+private:
+    std::ofstream out_;
+};
+
+// 优先创建 uinput 设备, 不可用 (无权限、容器内、非 Linux) 时写入 fallback_path; 两者都失败时抛出异常
+inline std::shared_ptr<VirtualOutputSink> openVirtualGamepadSink(const std::string &fallback_path)
+{
+    std::string error = "uinput not supported";
+#ifdef __linux__
+    std::shared_ptr<UinputSink> uinput =
+        std::make_shared<UinputSink>(VirtualGamepad::name(), VirtualGamepad::keyCodes(), VirtualGamepad::absInfo());
+    if (uinput->ok())
+        return uinput;
+    error = uinput->error();
+#endif
+    std::shared_ptr<FileOutputSink> file = std::make_shared<FileOutputSink>(fallback_path);
+    if (!file->ok())
+        throw std::runtime_error("Virtual output: " + error + ", cannot open " + fallback_path);
+    return file;
+}